@@ -0,0 +1,51 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "neural_network/crossover.hpp"
+#include "neural_network/kernels.hpp"
+
+using namespace neuralnetwork;
+
+// Débit de chaque opérateur de croisement : crossover_bench [nparams] [répétitions]
+// Le débit compte les deux parents lus et l'enfant écrit.
+
+template <typename Scalar>
+static void bench(char const *name, size_t nparams, size_t repeat) {
+    std::vector<Scalar> first(nparams), second(nparams), child(nparams);
+
+    util::Random rng(1);
+    rng.uniform(first.data(), nparams);
+    rng.uniform(second.data(), nparams);
+
+    // 8 couches de même taille pour l'opérateur par couche
+    std::vector<size_t> blocks;
+    for (size_t l = 0; l < 8; l++)
+        blocks.push_back(nparams * l / 8);
+
+    for (unsigned t = 0; t <= static_cast<unsigned>(crossover_t::Layer); t++) {
+        crossover_t type = static_cast<crossover_t>(t);
+
+        recombination::apply<Scalar>(type, child, first, second, 0.5, blocks, rng); // mise en cache
+
+        auto begin = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < repeat; r++)
+            recombination::apply<Scalar>(type, child, first, second, 0.5, blocks, rng);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        double bytes = 3. * nparams * sizeof(Scalar) * repeat;
+        std::printf("%-7s %-11s %8.2f GB/s %10.1f Mparams/s\n", name, recombination::toString(type),
+                    bytes / seconds * 1e-9, nparams * repeat / seconds * 1e-6);
+    }
+}
+
+int main(int argc, char **argv) {
+    size_t nparams = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1 << 20;
+    size_t repeat = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 50;
+
+    std::printf("isa %s, %zu parametres, %zu repetitions\n", kernels::isaToString(kernels::isa()), nparams, repeat);
+
+    bench<double>("double", nparams, repeat);
+    bench<float>("float", nparams, repeat);
+}
@@ -0,0 +1,60 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "neural_network/kernels.hpp"
+#include "neural_network/quantized.hpp"
+
+using namespace neuralnetwork;
+
+// Réseau int8 contre le réseau double : quantized_bench [ninput] [nhidden] [couches cachées] [échantillons]
+// Accord des argmax et écart des sorties sur un jeu d'entrées enregistré, puis débit de chaque version.
+
+template <typename Compute>
+static double rate(size_t samples, Compute compute) {
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t k = 0; k < samples; k++)
+        compute(k);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return samples / seconds;
+}
+
+int main(int argc, char **argv) {
+    NeuralParameters params;
+    params.ninput = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 256;
+    params.nhidden = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 256;
+    params.nhiddenlayer = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 2;
+    params.noutput = 4;
+    params.input_activation = activation_t::Identity;
+    params.hidden_activation = activation_t::Tanh;
+    params.output_activation = activation_t::Identity;
+    size_t samples = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 20000;
+
+    util::Random rng(1);
+    NeuralNetwork network(params, rng);
+
+    // poids ramenés à une échelle où tanh ne sature pas
+    for (double &w : network.params())
+        w /= std::sqrt((double)std::max(params.ninput, params.nhidden));
+
+    InputRecord record(params.ninput);
+    std::vector<double> inputs(params.ninput);
+    for (size_t k = 0; k < samples; k++) {
+        rng.normal(inputs.data(), inputs.size());
+        record.record(inputs);
+    }
+
+    for (kernels::isa_t isa : {kernels::isa_t::Scalar, kernels::detect()}) {
+        kernels::isa(isa);
+        QuantizedNetwork quantized(network);
+        QuantizationReport report = compareQuantized(network, quantized, record);
+
+        double reference = rate(samples, [&](size_t k) { network.compute(record[k]); });
+        double int8 = rate(samples, [&](size_t k) { quantized.compute(record[k]); });
+
+        std::printf("%-8s int8 %-8s accord %6.2f %%  ecart max %.3g moyen %.3g  double %8.0f/s  int8 %8.0f/s  x%.2f\n",
+                    kernels::isaToString(kernels::isa()), kernels::int8Kernel(), 100 * report.agreement(), report.max_error,
+                    report.mean_error, reference, int8, int8 / reference);
+    }
+}
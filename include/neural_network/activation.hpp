@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace neuralnetwork
+{
+
+    // Identifiant d'une fonction d'activation.
+    // Les valeurs nommées sont les activations intégrées, les activations ajoutées
+    // au registre reçoivent les identifiants suivants.
+    //
+    // Erreur absolue maximale par rapport à la fonction exacte (mesurée sur [-40, 40], en double) :
+    //  - Sigmoid         : exp de la libm, référence
+    //  - FastSigmoid     : exp par réduction 2^n * P(r), polynôme de degré 7 (6 en float), < 2e-9 (1e-7 en float)
+    //  - RationalSigmoid : 0.5 + 0.5 * x / (1 + |x|), forme différente de la sigmoïde, < 0.083
+    //  - SigmoidLut      : table de 4096 intervalles sur [-16, 16] + interpolation linéaire, < 8e-7 (1e-6 en float)
+    //  - Tanh, ReLU, Identity : exactes
+    enum class activation_t : unsigned
+    {
+        Sigmoid,
+        FastSigmoid,
+        RationalSigmoid,
+        SigmoidLut,
+        Tanh,
+        ReLU,
+        Identity
+    };
+
+    // Une activation existe en version scalaire et en version appliquée sur un tableau,
+    // la version tableau est vectorisée quand le processeur le permet
+    template <typename Scalar>
+    struct ActivationFunctions
+    {
+        Scalar (*scalar)(Scalar x);
+        void (*apply)(Scalar *values, size_t n);
+    };
+
+    //
+    struct Activation
+    {
+        std::string name;
+        double error_bound; // erreur absolue max par rapport à la fonction exacte
+        bool strictly_increasing; // deux entrées différentes ne donnent jamais la même sortie : l'argmax peut se faire avant
+                                  // l'activation. Seule Identity l'est en flottant : ReLU écrase les négatifs à 0, les sigmoïdes
+                                  // et tanh arrondissent à 0, 0.5 ou 1 aux extrémités et autour de 0.
+
+        ActivationFunctions<float> f32;
+        ActivationFunctions<double> f64;
+
+        template <typename Scalar>
+        ActivationFunctions<Scalar> const &functions() const;
+    };
+
+    template <>
+    inline ActivationFunctions<float> const &Activation::functions<float>() const {
+        return f32;
+    }
+
+    template <>
+    inline ActivationFunctions<double> const &Activation::functions<double>() const {
+        return f64;
+    }
+
+    // Registre des activations, les activations intégrées sont enregistrées à la construction.
+    // Les ajouts doivent se faire avant de lancer des calculs sur plusieurs threads.
+    class ActivationRegistry
+    {
+    private:
+        std::vector<Activation> m_activations;
+
+        ActivationRegistry();
+
+        ActivationRegistry(ActivationRegistry const &) = delete;
+        ActivationRegistry &operator=(ActivationRegistry const &) = delete;
+
+    public:
+        static ActivationRegistry &singleton();
+
+        activation_t add(Activation const &activation); //enregistre une activation, retourne son identifiant
+
+        Activation const &operator[](activation_t id) const {
+            return m_activations[static_cast<unsigned>(id)];
+        }
+
+        bool find(std::string const &name, activation_t &id) const;
+
+        size_t size() const {
+            return m_activations.size();
+        }
+    };
+
+    template <typename Scalar>
+    inline Scalar activate(activation_t id, Scalar x) {
+        return ActivationRegistry::singleton()[id].functions<Scalar>().scalar(x);
+    }
+
+    template <typename Scalar>
+    inline void activate(activation_t id, Scalar *values, size_t n) {
+        ActivationRegistry::singleton()[id].functions<Scalar>().apply(values, n);
+    }
+
+} // namespace neuralnetwork
@@ -0,0 +1,262 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "neural_network/population.hpp"
+#include "utils/mapped_file.hpp"
+#include "utils/span.hpp"
+
+namespace neuralnetwork
+{
+
+    // Point de reprise binaire d'une BasicPopulation, utilisable en place après un mmap :
+    //
+    //   [Header]                  en-tête fixe et versionné, complété par des zéros jusqu'à params_offset
+    //   [génome 0][génome 1] ...  params_offset aligné sur une page, un génome tous les stride octets (multiple de 64)
+    //   [score 0][score 1] ...    scores_offset aligné sur une page, un double par génome : son score à la dernière
+    //                             évaluation, NaN s'il n'a pas encore été joué
+    //
+    // Les valeurs sont dans l'ordre d'octets de la machine qui a écrit, vérifié au chargement.
+    // L'état aléatoire de la population tient dans (seed, génération) : chaque enfant tire dans le flux
+    // (seed, génération, indice), une population restaurée produit donc exactement les mêmes générations.
+    //
+    // Entre deux runs, la génération courante vient d'être produite : seules les élites ont un score.
+    // Depuis BasicPopulation::evaluated, le point de reprise contient la génération jouée avec tous ses scores ;
+    // restaurée, elle est rejouée par le run suivant (mêmes scores pour un jeu déterministe) puis évolue à l'identique.
+    // Réservé aux réseaux de taille fixe (FixedTopology : BasicNeuralNetwork, BasicStaticNeuralNetwork), vérifié à la compilation.
+    namespace checkpoint
+    {
+        constexpr uint32_t VERSION = 1;
+        constexpr uint32_t ENDIAN = 0x01020304;
+        constexpr char MAGIC[8] = {'V', 'K', 'N', 'C', 'K', 'P', 'T', 0};
+
+        constexpr uint64_t PAGE = 4096;
+        constexpr uint64_t ALIGN = 64; // alignement de chaque génome
+
+        // NeuralParameters en largeurs fixes, indépendant de la disposition de la structure
+        struct Parameters
+        {
+            double crossover_rate;
+            double mutation_rate;
+            double mutation_sigma;
+            double add_node_rate;
+            double add_connection_rate;
+            double compatibility_disjoint;
+            double compatibility_weight;
+            double compatibility_threshold;
+            uint64_t fitness_cache;
+            uint64_t seed;
+            uint32_t nhiddenlayer;
+            uint32_t ninput;
+            uint32_t nhidden;
+            uint32_t noutput;
+            uint32_t elitism;
+            uint32_t top_k;
+            uint32_t crossover;
+            uint32_t selection;
+            uint32_t tournament_size;
+            uint32_t input_activation;
+            uint32_t hidden_activation;
+            uint32_t output_activation;
+
+            Parameters() = default;
+            Parameters(NeuralParameters const &params);
+
+            NeuralParameters decode() const;
+        };
+
+        struct Header
+        {
+            char magic[8];
+            uint32_t version;
+            uint32_t endian;
+            uint32_t header_size;
+            uint32_t scalar_size; // 4 : float, 8 : double
+
+            uint64_t population;
+            uint64_t nparams; // valeurs par génome
+            uint64_t stride;  // octets entre deux génomes
+            uint64_t params_offset;
+            uint64_t scores_offset;
+            uint64_t file_size;
+
+            uint64_t generation;
+            Parameters params;
+
+            uint64_t checksum; // empreinte des octets qui précèdent
+        };
+
+        static_assert(sizeof(Parameters) == 128, "checkpoint::Parameters : disposition du format");
+        static_assert(sizeof(Header) == 216, "checkpoint::Header : disposition du format");
+
+        // en-tête complet (offsets, taille, empreinte) d'une population de population génomes de nparams valeurs
+        Header header(NeuralParameters const &params, uint64_t population, uint64_t nparams, uint32_t scalar_size, uint64_t generation);
+
+        // vérifie la marque, la version, l'ordre des octets, l'empreinte et les offsets pour un fichier de size octets,
+        // lève std::runtime_error sinon
+        void validate(Header const &header, size_t size);
+
+        // Écriture séquentielle par gros blocs, un appel système par tampon plein
+        class Writer
+        {
+        private:
+            int m_fd;
+            std::string m_path;
+            std::vector<char> m_buffer;
+            size_t m_used;
+            uint64_t m_offset; // octets reçus, tampon compris
+
+            void flush();
+
+        public:
+            Writer(std::string const &path, size_t buffer = 8 << 20);
+            ~Writer(); // ferme le fichier sans vérifier, voir close
+
+            Writer(Writer const &) = delete;
+            Writer &operator=(Writer const &) = delete;
+
+            void write(void const *data, size_t size);
+            void pad(uint64_t offset); // zéros jusqu'à offset
+
+            uint64_t offset() const {
+                return m_offset;
+            }
+
+            void sync(); // vide le tampon et attend que le contenu soit sur le disque (fsync)
+            void close(); // vide le tampon et ferme, lève std::runtime_error si une écriture a échoué
+        };
+
+        // directory/prefix-<génération sur 8 chiffres>.extension
+        std::string path(std::string const &directory, std::string const &prefix, uint64_t generation, char const *extension = "ckpt");
+
+        // Écrit un point de reprise complet dans path : genomes[i] pointe sur les header.nparams valeurs du génome i,
+        // scores[i] est son score. sync : fsync avant de fermer
+        void write(Header const &header, std::vector<void const *> const &genomes, util::Span<double const> scores, std::string const &path,
+                   bool sync = false);
+    } // namespace checkpoint
+
+    // Point de reprise projeté en mémoire : l'en-tête est vérifié à l'ouverture,
+    // les génomes et les scores sont lus en place, sans copie ni décodage.
+    class MappedCheckpoint
+    {
+    private:
+        util::MappedFile m_file;
+        checkpoint::Header const *m_header;
+
+        char const *bytes() const {
+            return static_cast<char const *>(m_file.data());
+        }
+
+    public:
+        MappedCheckpoint(std::string const &path);
+
+        checkpoint::Header const &header() const {
+            return *m_header;
+        }
+
+        NeuralParameters parameters() const {
+            return m_header->params.decode();
+        }
+
+        size_t size() const {
+            return m_header->population;
+        } // nombre de génomes
+
+        size_t nparams() const {
+            return m_header->nparams;
+        }
+
+        uint64_t generation() const {
+            return m_header->generation;
+        }
+
+        // valeurs du génome index, Scalar doit être le type écrit
+        template <typename Scalar>
+        util::Span<Scalar const> genome(size_t index) const {
+            if (sizeof(Scalar) != m_header->scalar_size)
+                throw std::invalid_argument("MappedCheckpoint : type scalaire different de celui du fichier");
+            if (index >= m_header->population)
+                throw std::out_of_range("MappedCheckpoint : genome hors du fichier");
+
+            char const *data = bytes() + m_header->params_offset + index * m_header->stride;
+            return util::Span<Scalar const>(reinterpret_cast<Scalar const *>(data), m_header->nparams);
+        }
+
+        // génome index sans type, header().nparams valeurs de header().scalar_size octets
+        void const *data(size_t index) const {
+            if (index >= m_header->population)
+                throw std::out_of_range("MappedCheckpoint : genome hors du fichier");
+            return bytes() + m_header->params_offset + index * m_header->stride;
+        }
+
+        util::Span<double const> scores() const {
+            return util::Span<double const>(reinterpret_cast<double const *>(bytes() + m_header->scores_offset), m_header->population);
+        }
+
+        void prefetch() const {
+            m_file.sequential();
+        } // lecture complète à venir : le noyau lit en avance
+    };
+
+    // Écrit la génération courante de population dans path (écrasé s'il existe), avec le score de chaque réseau :
+    // appelé depuis BasicPopulation::evaluated, ce sont ceux de la génération jouée, voir checkpoint
+    template <typename Network>
+    void saveCheckpoint(BasicPopulation<Network> const &population, std::string const &path) {
+        using Scalar = typename Network::scalar_type;
+        static_assert(FixedTopology<Network>::value, "saveCheckpoint : reseaux de topologie fixe uniquement, la structure d'un genome NEAT n'est pas enregistree");
+
+        size_t const n = population.size();
+        size_t const nparams = population[0].params().size();
+
+        std::vector<void const *> genomes(n);
+        std::vector<double> scores(n);
+
+        for (size_t i = 0; i < n; i++) {
+            if (population[i].params().size() != nparams)
+                throw std::invalid_argument("saveCheckpoint : genomes de tailles differentes");
+
+            genomes[i] = population[i].params().data();
+            scores[i] = population[i].score();
+        }
+
+        checkpoint::write(checkpoint::header(population.parameters(), n, nparams, sizeof(Scalar), population.generation()), genomes, scores, path);
+    }
+
+    // Population reconstruite depuis un point de reprise : paramètres, génération, génomes et scores
+    template <typename Network>
+    BasicPopulation<Network> loadCheckpoint(MappedCheckpoint const &checkpoint) {
+        using Scalar = typename Network::scalar_type;
+        static_assert(FixedTopology<Network>::value, "loadCheckpoint : reseaux de topologie fixe uniquement, la structure d'un genome NEAT n'est pas enregistree");
+
+        NeuralParameters const params = checkpoint.parameters();
+
+        // un seul réseau tiré, pour la topologie et les activations : les génomes sont construits depuis le fichier
+        util::Random rng(params.seed);
+        Network const shape(params, rng);
+        if (shape.params().size() != checkpoint.nparams())
+            throw std::runtime_error("loadCheckpoint : topologie differente de celle du fichier");
+
+        util::Span<double const> scores = checkpoint.scores();
+
+        BasicPopulation<Network> population(checkpoint.size(), params, [&](size_t i) {
+            Network network(shape, checkpoint.genome<Scalar>(i));
+            network.score(scores[i]);
+            return network;
+        });
+
+        population.generation(checkpoint.generation());
+        return population;
+    }
+
+    template <typename Network>
+    BasicPopulation<Network> loadCheckpoint(std::string const &path) {
+        MappedCheckpoint checkpoint(path);
+        checkpoint.prefetch();
+        return loadCheckpoint<Network>(checkpoint);
+    }
+
+} // namespace neuralnetwork
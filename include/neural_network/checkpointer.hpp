@@ -0,0 +1,156 @@
+#pragma once
+
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "neural_network/checkpoint.hpp"
+
+namespace neuralnetwork
+{
+
+    struct CheckpointerStats
+    {
+        size_t written = 0; // points de reprise terminés
+        size_t skipped = 0; // demandes ignorées, l'écriture précédente n'était pas finie
+        size_t failed = 0;
+        std::string error;  // dernière erreur
+
+        double stall = 0;     // secondes pendant lesquelles l'entraînement a attendu : captures et attentes dans evolve
+        double max_stall = 0; // plus long de ces blocages
+        double write = 0;     // durée de la dernière écriture, fsync et renommage compris
+        uint64_t bytes = 0;   // taille du dernier point de reprise
+
+        uint64_t generation = 0; // génération du dernier point de reprise
+        size_t unscored = 0;     // ses réseaux sans score (NaN) : les enfants pas encore joués, 0 depuis BasicPopulation::evaluated
+    };
+
+    // Écrit des points de reprise sur un thread dédié pendant que l'entraînement continue.
+    // save ne copie que l'adresse des génomes et les scores : les génomes sont lus en place dans la population,
+    // qui ne les réutilise qu'au deuxième evolve suivant (voir BasicPopulation::pin). L'entraînement n'attend donc
+    // que si une écriture dure plus d'une génération. Une demande faite pendant une écriture est ignorée.
+    //
+    // Les scores enregistrés sont ceux que portent les réseaux au moment de save : appelé depuis
+    // BasicPopulation::evaluated, ceux de la génération qui vient d'être jouée ; entre deux runs, seules les élites
+    // en ont un, les enfants valent NaN (voir CheckpointerStats::unscored).
+    //
+    // Chaque fichier est écrit sous un nom temporaire, synchronisé (fsync) puis renommé : un fichier
+    // directory/prefix-<génération>.ckpt est toujours complet, même après un arrêt brutal.
+    // Seuls les keep plus récents sont gardés (0 : tous).
+    class Checkpointer
+    {
+    private:
+        struct Job
+        {
+            checkpoint::Header header;
+            std::vector<void const *> genomes;
+            std::vector<double> scores;
+            size_t unscored;
+        };
+
+        // partagé avec les populations lues, qui peuvent survivre au Checkpointer
+        struct State
+        {
+            std::mutex mutex;
+            std::condition_variable wake;
+            std::condition_variable done;
+
+            bool busy = false; // job en cours d'écriture
+            bool stop = false;
+            Job job;
+
+            CheckpointerStats stats;
+            std::string latest;
+
+            void wait(bool stall); // attend la fin de l'écriture en cours, stall : compté comme blocage
+            void stalled(double seconds);
+        };
+
+        std::string m_directory;
+        std::string m_prefix;
+        size_t m_keep;
+
+        std::shared_ptr<State> m_state;
+        std::thread m_thread;
+
+        void work();
+        void write(Job const &job); // fichier temporaire, fsync, renommage puis rotation
+        void prune();
+
+    public:
+        Checkpointer(std::string const &directory, std::string const &prefix = "population", size_t keep = 3);
+        ~Checkpointer(); // termine l'écriture en cours
+
+        Checkpointer(Checkpointer const &) = delete;
+        Checkpointer &operator=(Checkpointer const &) = delete;
+
+        // Lance l'écriture de la génération courante, false si la précédente n'est pas finie.
+        // ex : population.evaluated([&](Population &p) { checkpointer.save(p); });
+        template <typename Network>
+        bool save(BasicPopulation<Network> &population);
+
+        void wait(); // attend la fin de l'écriture en cours
+
+        CheckpointerStats stats() const;
+
+        std::string latest() const; // dernier point de reprise complet, vide s'il n'y en a pas
+
+        std::string path(uint64_t generation) const;
+    };
+
+    template <typename Network>
+    bool Checkpointer::save(BasicPopulation<Network> &population) {
+        using Scalar = typename Network::scalar_type;
+        static_assert(FixedTopology<Network>::value, "Checkpointer : reseaux de topologie fixe uniquement, la structure d'un genome NEAT n'est pas enregistree");
+
+        auto const start = std::chrono::steady_clock::now();
+
+        {
+            std::lock_guard<std::mutex> lock(m_state->mutex);
+
+            if (m_state->busy) {
+                m_state->stats.skipped++;
+                return false;
+            }
+        }
+
+        // avant de marquer le job : pin attend la fin de la lecture précédente, déjà terminée
+        std::shared_ptr<State> state = m_state;
+        population.pin([state] { state->wait(true); });
+
+        {
+            std::lock_guard<std::mutex> lock(m_state->mutex);
+
+            // le thread d'écriture est inactif, le job peut être rempli
+            Job &job = m_state->job;
+            size_t const n = population.size();
+            size_t const nparams = population[0].params().size();
+
+            job.genomes.resize(n);
+            job.scores.resize(n);
+            job.unscored = 0;
+
+            for (size_t i = 0; i < n; i++) {
+                if (population[i].params().size() != nparams)
+                    throw std::invalid_argument("Checkpointer : genomes de tailles differentes");
+
+                job.genomes[i] = population[i].params().data();
+                job.scores[i] = population[i].score();
+                job.unscored += std::isnan(job.scores[i]);
+            }
+
+            job.header = checkpoint::header(population.parameters(), n, nparams, sizeof(Scalar), population.generation());
+            m_state->busy = true;
+        }
+        m_state->wake.notify_one();
+
+        m_state->stalled(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        return true;
+    }
+
+} // namespace neuralnetwork
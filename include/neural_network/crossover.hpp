@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+
+#include "utils/random.hpp"
+#include "utils/span.hpp"
+
+namespace neuralnetwork
+{
+
+    // Croisement de deux génomes à plat, rate est la part attendue du premier parent :
+    //  - OnePoint   : les rate * n premiers paramètres du premier parent, le reste du second (déterministe)
+    //  - TwoPoint   : un segment de (1 - rate) * n paramètres du second parent, à une position aléatoire
+    //  - Uniform    : chaque paramètre de l'un ou l'autre parent selon un bit aléatoire, rate ignoré (1/2)
+    //  - Arithmetic : rate * premier + (1 - rate) * second, paramètre par paramètre
+    //  - Layer      : chaque couche entière (poids et biais) du premier parent avec la probabilité rate
+    enum class crossover_t : unsigned
+    {
+        OnePoint,
+        TwoPoint,
+        Uniform,
+        Arithmetic,
+        Layer
+    };
+
+    // Opérateurs sur des zones contigues, child peut être confondu avec first ou second.
+    // Les copies passent par memcpy, Uniform mélange par masques de bits (AVX2 si le processeur le permet).
+    // Le résultat ne dépend pas du jeu d'instructions : un tirage 64 bits par bloc de 64 paramètres.
+    // Instanciés pour float et double dans crossover.cpp.
+    namespace recombination
+    {
+
+        template <typename Scalar>
+        void onePoint(util::Span<Scalar> child, util::Span<Scalar const> first, util::Span<Scalar const> second, size_t cut);
+
+        template <typename Scalar>
+        void twoPoint(util::Span<Scalar> child, util::Span<Scalar const> first, util::Span<Scalar const> second, size_t begin, size_t end);
+
+        template <typename Scalar>
+        void uniform(util::Span<Scalar> child, util::Span<Scalar const> first, util::Span<Scalar const> second, util::Random &rng);
+
+        template <typename Scalar>
+        void arithmetic(util::Span<Scalar> child, util::Span<Scalar const> first, util::Span<Scalar const> second, double alpha);
+
+        // blocks : début de chaque couche dans le génome, croissant, la dernière couche va jusqu'à la fin
+        template <typename Scalar>
+        void layer(util::Span<Scalar> child, util::Span<Scalar const> first, util::Span<Scalar const> second,
+                   util::Span<size_t const> blocks, double rate, util::Random &rng);
+
+        // segment [begin, end[ de (1 - rate) * n paramètres à une position aléatoire, utilisé par apply pour TwoPoint
+        void twoPointRange(size_t n, double rate, util::Random &rng, size_t &begin, size_t &end);
+
+        // choisit l'opérateur et ses points de coupe selon type et rate, voir crossover_t
+        template <typename Scalar>
+        void apply(crossover_t type, util::Span<Scalar> child, util::Span<Scalar const> first, util::Span<Scalar const> second,
+                   double rate, util::Span<size_t const> blocks, util::Random &rng);
+
+        char const *toString(crossover_t type);
+
+    } // namespace recombination
+
+} // namespace neuralnetwork
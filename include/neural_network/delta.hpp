@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "neural_network/checkpoint.hpp"
+
+namespace neuralnetwork
+{
+
+    // Historique incrémental d'une population : une base complète (format checkpoint) toutes les interval générations,
+    // puis un delta par génération, directory/prefix-<génération>.delta, qui ne se lit qu'à partir de la précédente.
+    //
+    // Un enfant est le croisement de deux parents suivi de mutations rares (voir BasicPopulation::parents) : chaque génome
+    // est codé par rapport à ses parents dans la génération précédente, en plages « copié du premier parent »,
+    // « copié du second » et valeurs littérales. Un littéral est ses bits XOR ceux du parent de la plage, en varint :
+    // une petite perturbation garde le signe et l'exposant. Une élite tient en quelques octets.
+    // Le codage compare les bits exacts : un parent faux (migrant, population restaurée) coûte de la place, pas de précision.
+    namespace delta
+    {
+        constexpr uint32_t VERSION = 1;
+        constexpr char MAGIC[8] = {'V', 'K', 'N', 'D', 'E', 'L', 'T', 'A'};
+
+        //   [Header][scores : double * population][index : uint64_t * (population + 1)][payload]
+        // le génome i occupe payload[index[i] .. index[i + 1]] : ses deux parents en varint, puis les plages
+        struct Header
+        {
+            char magic[8];
+            uint32_t version;
+            uint32_t endian;
+            uint32_t header_size;
+            uint32_t scalar_size;
+
+            uint64_t population;
+            uint64_t nparams;
+            uint64_t generation; // la génération précédente est la référence
+
+            uint64_t scores_offset;
+            uint64_t index_offset;
+            uint64_t payload_offset;
+            uint64_t payload_size;
+            uint64_t file_size;
+
+            uint64_t data_checksum; // empreinte des scores, de l'index et du payload
+            uint64_t checksum;      // empreinte des octets qui précèdent
+        };
+
+        static_assert(sizeof(Header) == 104, "delta::Header : disposition du format");
+
+        // code child (n valeurs de scalar_size octets) par rapport à first et second, à la suite de out
+        void encode(void const *child, void const *first, void const *second, size_t n, uint32_t scalar_size, std::vector<uint8_t> &out);
+
+        // inverse de encode, lève std::runtime_error si data ne décrit pas exactement n valeurs
+        void decode(uint8_t const *data, size_t size, void const *first, void const *second, void *child, size_t n, uint32_t scalar_size);
+
+        // Génération complète en mémoire, génomes contigus
+        struct Snapshot
+        {
+            checkpoint::Header header;
+            std::vector<char> genomes;
+            std::vector<double> scores;
+
+            void const *genome(size_t index) const {
+                return genomes.data() + index * header.nparams * header.scalar_size;
+            }
+        };
+
+        // dernière base avant generation puis les deltas suivants, lève std::runtime_error s'il manque un fichier
+        Snapshot reconstruct(std::string const &directory, std::string const &prefix, uint64_t generation);
+
+        void save(Snapshot const &snapshot, std::string const &path); // en point de reprise complet, voir loadCheckpoint
+    } // namespace delta
+
+    struct HistoryStats
+    {
+        size_t bases = 0;
+        size_t deltas = 0;
+        uint64_t bytes = 0;      // octets écrits
+        uint64_t full_bytes = 0; // taille des mêmes générations en points de reprise complets
+
+        double ratio() const {
+            return full_bytes == 0 ? 0 : (double)bytes / full_bytes;
+        }
+    };
+
+    // Enregistre chaque génération d'une population dans un historique (voir delta).
+    // Une base est écrite toutes les interval générations, et quand la génération enregistrée ne suit pas la précédente.
+    class CheckpointHistory
+    {
+    private:
+        std::string m_directory;
+        std::string m_prefix;
+        uint64_t m_interval;
+
+        delta::Snapshot m_previous; // référence du prochain delta
+        bool m_has_previous;
+
+        std::vector<uint8_t> m_payload;
+        std::vector<uint64_t> m_index;
+
+        HistoryStats m_stats;
+
+        void record(checkpoint::Header const &header, std::vector<void const *> const &genomes,
+                    std::vector<std::pair<size_t, size_t>> const &parents, std::vector<double> const &scores);
+
+    public:
+        CheckpointHistory(std::string const &directory, std::string const &prefix = "history", uint64_t interval = 50);
+
+        // à appeler à chaque génération depuis BasicPopulation::evaluated, les scores sont alors ceux de la génération jouée :
+        //   population.evaluated([&](Population &p) { history.record(p); });
+        // Entre deux runs, les génomes sont les mêmes mais les enfants n'ont pas encore de score (NaN).
+        template <typename Network>
+        void record(BasicPopulation<Network> const &population);
+
+        HistoryStats const &stats() const {
+            return m_stats;
+        }
+    };
+
+    template <typename Network>
+    void CheckpointHistory::record(BasicPopulation<Network> const &population) {
+        using Scalar = typename Network::scalar_type;
+        static_assert(FixedTopology<Network>::value, "CheckpointHistory : reseaux de topologie fixe uniquement, la structure d'un genome NEAT n'est pas enregistree");
+
+        size_t const n = population.size();
+        size_t const nparams = population[0].params().size();
+
+        std::vector<void const *> genomes(n);
+        std::vector<std::pair<size_t, size_t>> parents(n);
+        std::vector<double> scores(n);
+
+        for (size_t i = 0; i < n; i++) {
+            if (population[i].params().size() != nparams)
+                throw std::invalid_argument("CheckpointHistory : genomes de tailles differentes");
+
+            genomes[i] = population[i].params().data();
+            parents[i] = population.parents(i);
+            scores[i] = population[i].score();
+        }
+
+        record(checkpoint::header(population.parameters(), n, nparams, sizeof(Scalar), population.generation()), genomes, parents, scores);
+    }
+
+} // namespace neuralnetwork
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "neural_network/frozen_runtime.hpp"
+#include "neural_network/neural_network.hpp"
+#include "utils/span.hpp"
+
+namespace neuralnetwork
+{
+
+    // Réseau figé pour le déploiement (voir frozen_runtime.hpp) : topologie, activations et paramètres en float32,
+    // ou en int8 avec une échelle par neurone (max |w| / 127). Seules les activations intégrées sont exportables.
+    template <typename Scalar>
+    std::vector<unsigned char> freeze(Topology const &topology, util::Span<Scalar const> params, frozen::format_t format = frozen::format_t::Float32);
+
+    template <typename Scalar>
+    std::vector<unsigned char> freeze(BasicNeuralNetwork<Scalar> const &network, frozen::format_t format = frozen::format_t::Float32) {
+        return freeze(network.topology(), network.params(), format);
+    }
+
+    // ex : exportNetwork(population.bestElement(), "best.frozen"), lève std::runtime_error si l'écriture échoue
+    template <typename Scalar>
+    void exportNetwork(BasicNeuralNetwork<Scalar> const &network, std::string const &path, frozen::format_t format = frozen::format_t::Float32);
+
+    extern template std::vector<unsigned char> freeze<float>(Topology const &, util::Span<float const>, frozen::format_t);
+    extern template std::vector<unsigned char> freeze<double>(Topology const &, util::Span<double const>, frozen::format_t);
+    extern template void exportNetwork<float>(BasicNeuralNetwork<float> const &, std::string const &, frozen::format_t);
+    extern template void exportNetwork<double>(BasicNeuralNetwork<double> const &, std::string const &, frozen::format_t);
+
+} // namespace neuralnetwork
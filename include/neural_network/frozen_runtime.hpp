@@ -0,0 +1,355 @@
+#pragma once
+
+// Exécution d'un réseau exporté par neuralnetwork::exportNetwork (voir export.hpp), sans la bibliothèque d'entraînement :
+// ce header ne dépend que de la bibliothèque standard et peut être copié seul dans un autre projet.
+// Une seule allocation au chargement (fichier et buffers de calcul), aucune ensuite.
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+namespace neuralnetwork
+{
+    namespace frozen
+    {
+        constexpr uint32_t VERSION = 1;
+        constexpr uint32_t ENDIAN = 0x01020304;
+        constexpr char MAGIC[8] = {'V', 'K', 'N', 'F', 'R', 'O', 'Z', 'N'};
+
+        constexpr size_t ALIGN = 64; // début de chaque couche
+        constexpr size_t INT8_ROW = 32; // les lignes de poids int8 sont complétées à un multiple de 32
+
+        enum class format_t : uint32_t
+        {
+            Float32, // poids float
+            Int8     // poids int8 et une échelle float par neurone : w = scale * q
+        };
+
+        // mêmes valeurs que neuralnetwork::activation_t, seules les activations intégrées sont exportables.
+        // FastSigmoid et SigmoidLut sont calculées exactement (écart < 1e-6 avec l'entraînement).
+        enum activation : uint32_t
+        {
+            Sigmoid,
+            FastSigmoid,
+            RationalSigmoid,
+            SigmoidLut,
+            Tanh,
+            ReLU,
+            Identity
+        };
+
+        //   [Header][Layer * nlayers] puis, pour chaque couche l >= 1 à layers[l].offset (multiple de ALIGN) :
+        //   Float32 : poids float[size * stride], biais float[size]
+        //   Int8    : poids int8[size * stride], échelles float[size], biais float[size]
+        // le poids (neurone i, entrée j) est en i * stride + j, stride >= taille de la couche précédente
+        struct Header
+        {
+            char magic[8];
+            uint32_t version;
+            uint32_t endian;
+            uint32_t format;
+            uint32_t nlayers;
+            uint32_t max_width; // plus grande couche
+            uint32_t reserved;
+            uint64_t size;      // octets du fichier
+            uint64_t checksum;  // FNV-1a des octets qui suivent l'en-tête
+            uint64_t padding[2];
+        };
+
+        struct Layer
+        {
+            uint32_t size;
+            uint32_t activation;
+            uint32_t stride;
+            uint32_t reserved;
+            uint64_t offset; // 0 pour la couche d'entrée
+        };
+
+        static_assert(sizeof(Header) == 64, "frozen::Header : disposition du format");
+        static_assert(sizeof(Layer) == 24, "frozen::Layer : disposition du format");
+
+        inline uint64_t checksum(unsigned char const *data, size_t size) {
+            uint64_t h = 0xCBF29CE484222325ull;
+            for (size_t i = 0; i < size; i++)
+                h = (h ^ data[i]) * 0x100000001B3ull;
+            return h;
+        }
+
+        inline float activate(uint32_t id, float x) {
+            switch (id) {
+                case Sigmoid:
+                case FastSigmoid:
+                case SigmoidLut:
+                    return 1 / (1 + std::exp(-x));
+                case RationalSigmoid:
+                    return 0.5f + 0.5f * x / (1 + std::fabs(x));
+                case Tanh:
+                    return std::tanh(x);
+                case ReLU:
+                    return x > 0 ? x : 0;
+                default:
+                    return x;
+            }
+        }
+
+        // nullptr si data est un réseau figé valide de size octets, sinon la raison
+        inline char const *validate(unsigned char const *data, size_t size) {
+            if (size < sizeof(Header))
+                return "fichier trop court";
+
+            Header header;
+            std::memcpy(&header, data, sizeof(header));
+
+            if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+                return "fichier non reconnu";
+            if (header.endian != ENDIAN)
+                return "ordre des octets different de celui de la machine";
+            if (header.version != VERSION)
+                return "version non supportee";
+            if (header.size != size)
+                return "taille incoherente";
+            if (header.format > static_cast<uint32_t>(format_t::Int8))
+                return "format inconnu";
+            if (header.nlayers < 2 || sizeof(Header) + header.nlayers * sizeof(Layer) > size)
+                return "table des couches invalide";
+            if (header.checksum != checksum(data + sizeof(Header), size - sizeof(Header)))
+                return "contenu corrompu";
+
+            size_t const value = header.format == static_cast<uint32_t>(format_t::Int8) ? 1 : sizeof(float);
+            size_t const extra = header.format == static_cast<uint32_t>(format_t::Int8) ? 2 : 1; // échelles, biais
+
+            for (uint32_t l = 0; l < header.nlayers; l++) {
+                Layer layer;
+                std::memcpy(&layer, data + sizeof(Header) + l * sizeof(Layer), sizeof(layer));
+
+                if (layer.size == 0 || layer.size > header.max_width || layer.activation > Identity)
+                    return "couche invalide";
+                if (l == 0)
+                    continue;
+
+                Layer previous;
+                std::memcpy(&previous, data + sizeof(Header) + (l - 1) * sizeof(Layer), sizeof(previous));
+
+                uint64_t bytes = (uint64_t)layer.size * layer.stride * value + (uint64_t)extra * layer.size * sizeof(float);
+                if (layer.stride < previous.size || layer.offset % ALIGN != 0 || layer.offset > size || bytes > size - layer.offset)
+                    return "couche hors du fichier";
+            }
+
+            return nullptr;
+        }
+
+        // Réseau figé prêt à calculer. Non copiable, une instance par thread (les buffers de calcul sont internes).
+        class Network
+        {
+        private:
+            unsigned char *m_data; // fichier puis deux buffers de max_width valeurs
+            size_t m_size;
+            char const *m_error;
+
+            Header const &header() const {
+                return *reinterpret_cast<Header const *>(m_data);
+            }
+
+            Layer const &layer(size_t l) const {
+                return reinterpret_cast<Layer const *>(m_data + sizeof(Header))[l];
+            }
+
+            static size_t scratchOffset(size_t size) {
+                return (size + ALIGN - 1) / ALIGN * ALIGN;
+            }
+
+            void release() {
+                if (m_data != nullptr)
+                    ::operator delete(m_data, std::align_val_t(ALIGN));
+                m_data = nullptr;
+                m_size = 0;
+            }
+
+            // alloue fichier et buffers de calcul d'après l'en-tête, y place les size octets lus par read(buffer), puis vérifie
+            template <typename Read>
+            bool adopt(Header const &header, size_t size, Read read) {
+                release();
+
+                // chaque couche occupe au moins autant d'octets que sa largeur : borne l'allocation d'un en-tête faux
+                if (header.max_width == 0 || header.max_width > size) {
+                    m_error = "en-tete invalide";
+                    return false;
+                }
+
+                size_t scratch = 2 * (size_t)header.max_width * sizeof(float);
+                m_data = static_cast<unsigned char *>(::operator new(scratchOffset(size) + scratch, std::align_val_t(ALIGN)));
+                m_size = size;
+
+                if (!read(m_data)) {
+                    m_error = "lecture impossible";
+                    release();
+                    return false;
+                }
+
+                if ((m_error = validate(m_data, size)) != nullptr) {
+                    release();
+                    return false;
+                }
+                return true;
+            }
+
+        public:
+            Network() : m_data(nullptr), m_size(0), m_error(nullptr) {}
+
+            ~Network() {
+                release();
+            }
+
+            Network(Network const &) = delete;
+            Network &operator=(Network const &) = delete;
+
+            Network(Network &&other) : m_data(other.m_data), m_size(other.m_size), m_error(other.m_error) {
+                other.m_data = nullptr;
+                other.m_size = 0;
+            }
+
+            Network &operator=(Network &&other) {
+                if (this != &other) {
+                    release();
+                    m_data = other.m_data;
+                    m_size = other.m_size;
+                    m_error = other.m_error;
+                    other.m_data = nullptr;
+                    other.m_size = 0;
+                }
+                return *this;
+            }
+
+            // copie size octets (ex : réseau embarqué dans l'exécutable), false si invalide, voir error
+            bool load(void const *data, size_t size) {
+                Header header;
+                if (size < sizeof(Header)) {
+                    release();
+                    m_error = "fichier trop court";
+                    return false;
+                }
+                std::memcpy(&header, data, sizeof(header));
+
+                return adopt(header, size, [&](unsigned char *buffer) {
+                    std::memcpy(buffer, data, size);
+                    return true;
+                });
+            }
+
+            bool load(char const *path) {
+                release();
+
+                std::FILE *file = std::fopen(path, "rb");
+                if (file == nullptr) {
+                    m_error = "ouverture impossible";
+                    return false;
+                }
+
+                Header header;
+                long size = -1;
+                if (std::fseek(file, 0, SEEK_END) == 0)
+                    size = std::ftell(file);
+
+                bool ok = false;
+                if (size < (long)sizeof(Header))
+                    m_error = size < 0 ? "lecture impossible" : "fichier trop court";
+                else if (std::fseek(file, 0, SEEK_SET) != 0 || std::fread(&header, sizeof(header), 1, file) != 1 || std::fseek(file, 0, SEEK_SET) != 0)
+                    m_error = "lecture impossible";
+                else
+                    ok = adopt(header, size, [&](unsigned char *buffer) { return std::fread(buffer, 1, size, file) == (size_t)size; });
+
+                std::fclose(file);
+                return ok;
+            }
+
+            bool loaded() const {
+                return m_data != nullptr;
+            }
+
+            char const *error() const {
+                return m_error;
+            } // raison du dernier échec de load
+
+            format_t format() const {
+                return static_cast<format_t>(header().format);
+            }
+
+            size_t nlayers() const {
+                return header().nlayers;
+            }
+
+            size_t size(size_t l) const {
+                return layer(l).size;
+            } // taille de la couche l
+
+            size_t ninput() const {
+                return layer(0).size;
+            }
+
+            size_t noutput() const {
+                return layer(header().nlayers - 1).size;
+            }
+
+            // ninput() valeurs en entrée, copie les noutput() activations de sortie dans outputs si fourni,
+            // renvoie l'indice de la plus grande (la première à égalité). Aucune allocation.
+            size_t compute(float const *inputs, float *outputs = nullptr) {
+                Header const &h = header();
+                float *current = reinterpret_cast<float *>(m_data + scratchOffset(m_size));
+                float *next = current + h.max_width;
+
+                Layer const &input = layer(0);
+                for (size_t j = 0; j < input.size; j++)
+                    current[j] = activate(input.activation, inputs[j]);
+
+                size_t width = input.size;
+
+                for (size_t l = 1; l < h.nlayers; l++) {
+                    Layer const &info = layer(l);
+                    unsigned char const *block = m_data + info.offset;
+
+                    if (h.format == static_cast<uint32_t>(format_t::Int8)) {
+                        int8_t const *weights = reinterpret_cast<int8_t const *>(block);
+                        float const *scales = reinterpret_cast<float const *>(block + (size_t)info.size * info.stride);
+                        float const *bias = scales + info.size;
+
+                        for (size_t i = 0; i < info.size; i++) {
+                            int8_t const *row = weights + i * info.stride;
+                            float s = 0;
+                            for (size_t j = 0; j < width; j++)
+                                s += row[j] * current[j];
+                            next[i] = activate(info.activation, scales[i] * s + bias[i]);
+                        }
+                    } else {
+                        float const *weights = reinterpret_cast<float const *>(block);
+                        float const *bias = weights + (size_t)info.size * info.stride;
+
+                        for (size_t i = 0; i < info.size; i++) {
+                            float const *row = weights + i * info.stride;
+                            float s = bias[i];
+                            for (size_t j = 0; j < width; j++)
+                                s += row[j] * current[j];
+                            next[i] = activate(info.activation, s);
+                        }
+                    }
+
+                    float *tmp = current;
+                    current = next;
+                    next = tmp;
+                    width = info.size;
+                }
+
+                size_t res = 0;
+                for (size_t i = 0; i < width; i++) {
+                    if (current[i] > current[res])
+                        res = i;
+                    if (outputs != nullptr)
+                        outputs[i] = current[i];
+                }
+                return res;
+            }
+        };
+    } // namespace frozen
+} // namespace neuralnetwork
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "utils/random.hpp"
+#include "utils/span.hpp"
+
+namespace neuralnetwork
+{
+
+    // Empreinte du contenu d'un génome : somme (modulo 2^64) d'un mélange de (indice, bits de la valeur).
+    // La somme se met à jour en O(1) par paramètre modifié, et en O(segment) pour un croisement par coupe.
+    // Deux génomes identiques ont la même empreinte ; l'inverse est vrai à une collision 64 bits près.
+    namespace hashing
+    {
+
+        inline uint64_t bits(double value) {
+            uint64_t res;
+            std::memcpy(&res, &value, sizeof(res));
+            return res;
+        }
+
+        inline uint64_t bits(float value) {
+            uint32_t res;
+            std::memcpy(&res, &value, sizeof(res));
+            return res;
+        }
+
+        template <typename Scalar>
+        inline uint64_t element(size_t index, Scalar value) {
+            return util::mix64(bits(value) ^ (index * 0xD6E8FEB86659FD93ull));
+        }
+
+        template <typename Scalar>
+        inline uint64_t range(Scalar const *params, size_t begin, size_t end) {
+            uint64_t res = 0;
+            for (size_t i = begin; i < end; i++)
+                res += element(i, params[i]);
+            return res;
+        }
+
+        template <typename Scalar>
+        inline uint64_t genome(util::Span<Scalar const> params) {
+            return range(params.data(), 0, params.size());
+        }
+
+        // empreinte d'un enfant égal à first hors de [begin, end[ et à second dedans,
+        // calculée sur la plus courte des deux zones
+        template <typename Scalar>
+        inline uint64_t splice(util::Span<Scalar const> first, uint64_t first_hash, util::Span<Scalar const> second, uint64_t second_hash,
+                               size_t begin, size_t end) {
+            size_t n = first.size();
+
+            if (end - begin <= n - (end - begin))
+                return first_hash - range(first.data(), begin, end) + range(second.data(), begin, end);
+
+            uint64_t outside = range(second.data(), 0, begin) + range(second.data(), end, n);
+            uint64_t replaced = range(first.data(), 0, begin) + range(first.data(), end, n);
+            return second_hash - outside + replaced;
+        }
+
+    } // namespace hashing
+
+} // namespace neuralnetwork
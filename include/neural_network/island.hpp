@@ -0,0 +1,473 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "neural_network/neural_network.hpp"
+#include "utils/mailbox.hpp"
+#include "utils/random.hpp"
+#include "utils/shared_memory.hpp"
+#include "utils/thread_pool.hpp"
+
+namespace neuralnetwork
+{
+
+    // Destination des migrants d'une île i parmi n :
+    //  - Ring           : l'île (i + 1) % n
+    //  - FullyConnected : toutes les autres îles
+    //  - Random         : une autre île tirée à chaque migration, dans le flux (seed, migration, i)
+    enum class migration_t : unsigned
+    {
+        Ring,
+        FullyConnected,
+        Random
+    };
+
+    //
+    struct IslandParameters
+    {
+        unsigned islands = 4;
+        unsigned interval = 10; // générations entre deux migrations
+        unsigned migrants = 2;  // meilleurs réseaux envoyés à chaque migration
+        migration_t topology = migration_t::Ring;
+
+        bool processes = false; // une île par processus (fork) au lieu d'une par thread
+        std::string shm_name;   // segment nommé (ex : "/vulkai-islands") pour l'observer depuis un autre processus, vide : anonyme
+    };
+
+    // Compteurs d'une île, tenus dans le segment partagé
+    struct IslandStats
+    {
+        uint64_t generations = 0; // générations faites pendant le dernier run
+        uint64_t sent = 0;        // migrants envoyés depuis la création (une fois par destination)
+        uint64_t received = 0;    // migrants intégrés depuis la création
+        double best = 0;          // meilleur score de la dernière génération évaluée
+    };
+
+    // Modèle en îles : plusieurs BasicPopulation évoluent chacune de leur côté, dans un thread ou un processus,
+    // et échangent leurs meilleurs réseaux toutes les interval générations.
+    // Tout l'état partagé est dans un util::SharedMemory : pour chaque couple (source, destination) une util::Mailbox
+    // sans verrou qui garde la dernière migration, et pour chaque île ses compteurs et sa génération finale.
+    // Les îles ne s'attendent pas : une île intègre les migrations arrivées au moment où elle regarde,
+    // le résultat dépend donc de la vitesse relative des îles.
+    // Les migrants remplacent les derniers enfants de la génération courante, jamais les élites.
+    // Un migrant voyage sous forme de paramètres bruts : réservé aux réseaux de topologie fixe (FixedTopology).
+    template <typename Network>
+    class BasicIslands
+    {
+        static_assert(FixedTopology<Network>::value, "BasicIslands : reseaux de topologie fixe uniquement, un genome NEAT ne se resume pas a ses parametres");
+
+    public:
+        using network_type = Network;
+        using scalar_type = typename Network::scalar_type;
+        using population_type = BasicPopulation<Network>;
+
+    private:
+        struct alignas(64) IslandState
+        {
+            std::atomic<uint64_t> generations;
+            std::atomic<uint64_t> sent;
+            std::atomic<uint64_t> received;
+            uint64_t generation; // BasicPopulation::generation en fin de run
+            double best;
+        };
+
+        IslandParameters m_params;
+        uint64_t m_seed;
+
+        std::vector<population_type> m_islands;
+        std::vector<Network> m_best; // meilleur réseau de chaque île à la fin du dernier run
+
+        size_t m_population;
+        size_t m_replaceable; // réseaux non élites d'une génération
+        size_t m_nparams;
+        size_t m_message; // octets d'une migration : nombre de migrants puis (score, paramètres) par migrant
+
+        // segment : états, époques vues, génomes, meilleurs, scores, boites aux lettres
+        util::SharedMemory m_memory;
+        size_t m_seen_offset;
+        size_t m_genomes_offset;
+        size_t m_best_offset;
+        size_t m_scores_offset;
+        size_t m_mail_offset;
+
+        unsigned char *base() const {
+            return static_cast<unsigned char *>(m_memory.data());
+        }
+
+        IslandState &state(size_t island) const {
+            return reinterpret_cast<IslandState *>(base())[island];
+        }
+
+        uint64_t &seen(size_t destination, size_t source) const {
+            return reinterpret_cast<uint64_t *>(base() + m_seen_offset)[destination * m_params.islands + source];
+        } // dernière migration de source intégrée par destination, écrit par destination seulement
+
+        scalar_type *genomes(size_t island) const {
+            return reinterpret_cast<scalar_type *>(base() + m_genomes_offset) + island * m_population * m_nparams;
+        }
+
+        scalar_type *bestGenome(size_t island) const {
+            return reinterpret_cast<scalar_type *>(base() + m_best_offset) + island * m_nparams;
+        }
+
+        double *scores(size_t island) const {
+            return reinterpret_cast<double *>(base() + m_scores_offset) + island * m_population;
+        } // score de chaque génome de l'île, NaN pour un enfant pas encore évalué
+
+        util::Mailbox mailbox(size_t source, size_t destination) const {
+            size_t slot = source * m_params.islands + destination;
+            return util::Mailbox(base() + m_mail_offset + slot * util::Mailbox::footprint(m_message), m_message);
+        }
+
+        void evolve(size_t island, BasicGameFactory<Network> const &factory, unsigned generations);
+        void emigrate(size_t island, uint64_t migration, std::vector<unsigned char> &buffer);
+        void immigrate(size_t island, std::vector<unsigned char> &buffer);
+
+        void publish(size_t island);               // génomes, scores et meilleur de l'île vers le segment
+        void collect(size_t island, bool from_memory); // et retour, from_memory : l'île a tourné dans un autre processus
+
+        void runThreads(BasicGameFactory<Network> const &factory, unsigned generations);
+        void runProcesses(BasicGameFactory<Network> const &factory, unsigned generations);
+
+    public:
+        // Chaque île est une BasicPopulation de population_size réseaux, de graine dérivée de params.seed
+        BasicIslands(IslandParameters const &islands, unsigned population_size, NeuralParameters const &params);
+
+        BasicIslands(BasicIslands const &) = delete;
+        BasicIslands &operator=(BasicIslands const &) = delete;
+
+        // generations générations sur chaque île, une partie par île créée par factory.
+        // En mode processus, les populations sont recopiées depuis le segment à la fin :
+        // génomes, scores et génération. Les réseaux évalués restent dans le processus fils : stats(), top() et
+        // bestElement() de la population sont remis à zéro, le meilleur réseau de l'île est best(island).
+        void run(BasicGameFactory<Network> const &factory, unsigned generations);
+
+        size_t size() const {
+            return m_islands.size();
+        }
+
+        population_type &operator[](size_t island) {
+            return m_islands.at(island);
+        }
+
+        population_type const &operator[](size_t island) const {
+            return m_islands.at(island);
+        }
+
+        Network const &best(size_t island) const {
+            return m_best.at(island);
+        } // meilleur réseau de l'île à la fin du dernier run
+
+        Network const &bestElement() const; // meilleur réseau de toutes les îles
+
+        IslandStats stats(size_t island) const;
+
+        IslandParameters const &parameters() const {
+            return m_params;
+        }
+    };
+
+    using Islands = BasicIslands<NeuralNetwork>;
+    using Islandsf = BasicIslands<NeuralNetworkf>;
+
+    //////////////////////////////////////////////////////////////////////////////////////////////////
+    /////                                       Islands                                          /////
+    //////////////////////////////////////////////////////////////////////////////////////////////////
+
+    template <typename Network>
+    BasicIslands<Network>::BasicIslands(IslandParameters const &islands, unsigned population_size, NeuralParameters const &params)
+        : m_params(islands), m_seed(params.seed), m_population(population_size) {
+        if (islands.islands == 0 || population_size == 0)
+            throw std::invalid_argument("BasicIslands : il faut au moins une ile et un reseau");
+
+        m_replaceable = population_size - std::min(params.elitism, population_size);
+
+        m_params.interval = std::max(islands.interval, 1u);
+        m_params.migrants = std::min<size_t>(islands.migrants, m_replaceable);
+
+        for (unsigned i = 0; i < islands.islands; i++) {
+            NeuralParameters island = params;
+            island.seed = util::mix64(params.seed + i);
+            m_islands.emplace_back(population_size, island);
+        }
+
+        m_nparams = m_islands.front()[0].params().size();
+        m_best.assign(islands.islands, m_islands.front()[0]);
+
+        m_message = sizeof(uint64_t) + m_params.migrants * (sizeof(double) + m_nparams * sizeof(scalar_type));
+
+        auto align = [](size_t n) { return (n + 63) / 64 * 64; };
+        size_t const n = islands.islands;
+
+        m_seen_offset = align(n * sizeof(IslandState));
+        m_genomes_offset = m_seen_offset + align(n * n * sizeof(uint64_t));
+        m_best_offset = m_genomes_offset + align(n * m_population * m_nparams * sizeof(scalar_type));
+        m_scores_offset = m_best_offset + align(n * m_nparams * sizeof(scalar_type));
+        m_mail_offset = m_scores_offset + align(n * m_population * sizeof(double));
+
+        size_t total = m_mail_offset + n * n * util::Mailbox::footprint(m_message);
+
+        // segment nul : compteurs à 0, boites vides
+        m_memory = util::SharedMemory::create(total, islands.shm_name);
+
+        for (size_t i = 0; i < n; i++)
+            new (&state(i)) IslandState();
+    }
+
+    template <typename Network>
+    void BasicIslands<Network>::emigrate(size_t island, uint64_t migration, std::vector<unsigned char> &buffer){
+        population_type const &population = m_islands[island];
+        size_t const n = m_params.islands;
+
+        uint64_t count = std::min<size_t>(m_params.migrants, population.topSize());
+        if (count == 0 || n == 1)
+            return;
+
+        unsigned char *out = buffer.data();
+        std::memcpy(out, &count, sizeof(count));
+        out += sizeof(count);
+
+        for (size_t r = 0; r < count; r++) {
+            Network const &migrant = population.top(r);
+            double score = migrant.score();
+
+            std::memcpy(out, &score, sizeof(score));
+            std::memcpy(out + sizeof(score), migrant.params().data(), m_nparams * sizeof(scalar_type));
+            out += sizeof(score) + m_nparams * sizeof(scalar_type);
+        }
+
+        size_t size = out - buffer.data();
+        size_t destinations = 0;
+
+        switch (m_params.topology) {
+            case migration_t::Ring:
+                mailbox(island, (island + 1) % n).post(buffer.data(), size, migration);
+                destinations = 1;
+                break;
+
+            case migration_t::FullyConnected:
+                for (size_t d = 0; d < n; d++)
+                    if (d != island)
+                        mailbox(island, d).post(buffer.data(), size, migration);
+                destinations = n - 1;
+                break;
+
+            case migration_t::Random: {
+                util::Random rng = util::Random::stream(m_seed, migration, island);
+                size_t d = std::min<size_t>(rng.uniform() * (n - 1), n - 2);
+
+                mailbox(island, d >= island ? d + 1 : d).post(buffer.data(), size, migration);
+                destinations = 1;
+                break;
+            }
+        }
+
+        state(island).sent.fetch_add(count * destinations, std::memory_order_relaxed);
+    }
+
+    template <typename Network>
+    void BasicIslands<Network>::immigrate(size_t island, std::vector<unsigned char> &buffer){
+        population_type &population = m_islands[island];
+
+        // les enfants [elitism, size) sont remplaçables, en partant de la fin
+        size_t replaced = 0;
+
+        for (size_t source = 0; source < m_params.islands; source++) {
+            if (source == island)
+                continue;
+
+            util::Mailbox box = mailbox(source, island);
+            if (box.epoch() <= seen(island, source))
+                continue;
+
+            // une écriture en cours fait échouer la lecture : la migration sera reprise au prochain passage
+            uint64_t epoch;
+            size_t size;
+            if (!box.fetch(buffer.data(), buffer.size(), epoch, size) || epoch <= seen(island, source))
+                continue;
+
+            seen(island, source) = epoch;
+
+            uint64_t count;
+            std::memcpy(&count, buffer.data(), sizeof(count));
+            unsigned char const *in = buffer.data() + sizeof(count);
+
+            for (size_t r = 0; r < count && replaced < m_replaceable; r++) {
+                Network &target = population[m_population - 1 - replaced];
+                double score;
+
+                std::memcpy(&score, in, sizeof(score));
+                std::memcpy(target.params().data(), in + sizeof(score), m_nparams * sizeof(scalar_type));
+                target.rehash();
+                target.score(score);
+
+                in += sizeof(score) + m_nparams * sizeof(scalar_type);
+                replaced++;
+            }
+        }
+
+        state(island).received.fetch_add(replaced, std::memory_order_relaxed);
+    }
+
+    template <typename Network>
+    void BasicIslands<Network>::evolve(size_t island, BasicGameFactory<Network> const &factory, unsigned generations){
+        population_type &population = m_islands[island];
+        std::unique_ptr<BasicGame<Network>> game = factory();
+
+        std::vector<unsigned char> outgoing(m_message), incoming(m_message);
+        state(island).generations.store(0, std::memory_order_relaxed);
+
+        for (unsigned g = 0; g < generations; g++) {
+            population.run(*game);
+            state(island).generations.fetch_add(1, std::memory_order_relaxed);
+
+            // numéro de migration tiré de la génération de l'île : les îles se retrouvent sans horloge commune
+            if (population.generation() % m_params.interval == 0) {
+                uint64_t migration = population.generation() / m_params.interval;
+
+                emigrate(island, migration, outgoing);
+                immigrate(island, incoming);
+            }
+        }
+    }
+
+    template <typename Network>
+    void BasicIslands<Network>::publish(size_t island){
+        population_type &population = m_islands[island];
+        scalar_type *out = genomes(island);
+
+        double *score = scores(island);
+
+        for (size_t i = 0; i < m_population; i++) {
+            std::memcpy(out + i * m_nparams, population[i].params().data(), m_nparams * sizeof(scalar_type));
+            score[i] = population[i].score();
+        }
+
+        Network const &top = population.bestElement();
+        std::memcpy(bestGenome(island), top.params().data(), m_nparams * sizeof(scalar_type));
+
+        state(island).best = top.score();
+        state(island).generation = population.generation();
+    }
+
+    template <typename Network>
+    void BasicIslands<Network>::collect(size_t island, bool from_memory){
+        population_type &population = m_islands[island];
+
+        if (from_memory) {
+            scalar_type const *in = genomes(island);
+            double const *score = scores(island);
+
+            for (size_t i = 0; i < m_population; i++) {
+                std::memcpy(population[i].params().data(), in + i * m_nparams, m_nparams * sizeof(scalar_type));
+                population[i].rehash();
+                population[i].score(score[i]);
+            }
+
+            population.generation(state(island).generation);
+            population.forget(); // le classement du parent date d'avant le fork
+        }
+
+        Network &res = m_best[island];
+        std::memcpy(res.params().data(), bestGenome(island), m_nparams * sizeof(scalar_type));
+        res.rehash();
+        res.score(state(island).best);
+    }
+
+    template <typename Network>
+    void BasicIslands<Network>::runThreads(BasicGameFactory<Network> const &factory, unsigned generations){
+        util::ThreadPool pool(m_params.islands);
+
+        pool.run([&](size_t island) {
+            evolve(island, factory, generations);
+            publish(island);
+        });
+
+        for (size_t i = 0; i < m_params.islands; i++)
+            collect(i, false);
+    }
+
+    template <typename Network>
+    void BasicIslands<Network>::runProcesses(BasicGameFactory<Network> const &factory, unsigned generations){
+        std::vector<pid_t> children;
+        bool failed = false;
+
+        for (size_t island = 0; island < m_params.islands && !failed; island++) {
+            pid_t pid = fork();
+
+            if (pid == 0) {
+                // processus fils : une seule île, rien ne doit remonter la pile du parent
+                int status = 0;
+                try {
+                    evolve(island, factory, generations);
+                    publish(island);
+                } catch (...) {
+                    status = 1;
+                }
+                _exit(status);
+            }
+
+            if (pid < 0)
+                failed = true;
+            else
+                children.push_back(pid);
+        }
+
+        for (pid_t pid : children) {
+            int status;
+            if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+                failed = true;
+        }
+
+        if (failed)
+            throw std::runtime_error("BasicIslands : une ile n'a pas termine");
+
+        for (size_t i = 0; i < m_params.islands; i++)
+            collect(i, true);
+    }
+
+    template <typename Network>
+    void BasicIslands<Network>::run(BasicGameFactory<Network> const &factory, unsigned generations){
+        if (m_params.processes)
+            runProcesses(factory, generations);
+        else
+            runThreads(factory, generations);
+    }
+
+    template <typename Network>
+    Network const &BasicIslands<Network>::bestElement() const{
+        size_t res = 0;
+
+        for (size_t i = 1; i < m_best.size(); i++)
+            if (m_best[i].score() > m_best[res].score())
+                res = i;
+
+        return m_best[res];
+    }
+
+    template <typename Network>
+    IslandStats BasicIslands<Network>::stats(size_t island) const{
+        IslandState const &s = state(island);
+        IslandStats res;
+
+        res.generations = s.generations.load(std::memory_order_relaxed);
+        res.sent = s.sent.load(std::memory_order_relaxed);
+        res.received = s.received.load(std::memory_order_relaxed);
+        res.best = s.best;
+        return res;
+    }
+
+    extern template class BasicIslands<NeuralNetworkf>;
+    extern template class BasicIslands<NeuralNetwork>;
+
+} // namespace neuralnetwork
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace neuralnetwork
+{
+
+    // Noyaux de calcul du forward pass.
+    // Chaque noyau existe en version scalaire (référence), SSE2, AVX2 et AVX-512,
+    // la meilleure version supportée par le processeur est choisie au démarrage (CPUID).
+    namespace kernels
+    {
+
+        enum class isa_t {
+            Scalar,
+            SSE2,
+            AVX2,
+            AVX512
+        };
+
+        isa_t detect();      // meilleur jeu d'instructions supporté par le processeur
+        isa_t isa();         // jeu d'instructions utilisé actuellement
+        void isa(isa_t val); // force un jeu d'instructions, ramené au meilleur supporté si besoin, sûr pendant un calcul
+
+        char const *isaToString(isa_t val);
+
+        // out[i] = bias[i] + somme_j weights[i * cols + j] * in[j]
+        void dense(double const *weights, double const *bias, double const *in, double *out, size_t rows, size_t cols);
+        void dense(float const *weights, float const *bias, float const *in, float *out, size_t rows, size_t cols);
+
+        // acc[i] += a[i] * b[i]
+        void multiplyAdd(double *acc, double const *a, double const *b, size_t n);
+        void multiplyAdd(float *acc, float const *a, float const *b, size_t n);
+
+        // out[i] = somme_j weights[i * stride + j] * in[j] en entiers, stride multiple de 32 (lignes et entrée complétées par des zéros).
+        // in dans [0, 127] : sur 7 bits, vpmaddubsw (AVX2) ne sature pas et toutes les versions donnent le même résultat.
+        // AVX-VNNI (vpdpbusd) quand le processeur le supporte, sinon AVX2, version scalaire en dessous.
+        void dotInt8(int8_t const *weights, uint8_t const *in, int32_t *out, size_t rows, size_t stride);
+
+        char const *int8Kernel(); // version de dotInt8 utilisée actuellement
+
+    } // namespace kernels
+
+} // namespace neuralnetwork
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "utils/random.hpp"
+#include "utils/span.hpp"
+
+namespace neuralnetwork
+{
+
+    // Mutations sur un génome à plat (BasicNeuralNetwork::params, BasicLayer::weights, ...).
+    namespace mutation
+    {
+
+        // Ajoute N(0, sigma²) à chaque paramètre avec la probabilité rate.
+        // L'écart jusqu'au prochain paramètre muté suit une loi géométrique : un seul tirage par mutation
+        // au lieu d'un par paramètre, le coût est proportionnel à rate * params.size().
+        // Les perturbations sont tirées par blocs avec util::BasicRandom::normal (Box-Muller vectorisé).
+        // Si hash est fourni, l'empreinte du génome (genome_hash.hpp) est mise à jour pour chaque paramètre modifié.
+        template <typename Scalar>
+        void gaussian(util::Span<Scalar> params, double rate, double sigma, util::Random &rng, uint64_t *hash = nullptr);
+
+        extern template void gaussian<float>(util::Span<float>, double, double, util::Random &, uint64_t *);
+        extern template void gaussian<double>(util::Span<double>, double, double, util::Random &, uint64_t *);
+
+    } // namespace mutation
+
+} // namespace neuralnetwork
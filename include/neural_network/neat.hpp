@@ -0,0 +1,297 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "neural_network/neural_network.hpp"
+#include "neural_network/plan.hpp"
+#include "utils/random.hpp"
+#include "utils/span.hpp"
+
+namespace neuralnetwork
+{
+
+    // Marques historiques de NEAT. Elles sont structurelles au lieu d'être attribuées par un compteur global :
+    //  - la connexion in -> out a pour innovation neat::innovation(in, out),
+    //  - le noeud créé en coupant la connexion c a pour identifiant neat::splitNode(c, k), k le premier libre du génome.
+    // Deux génomes qui font la même mutation obtiennent donc les mêmes gènes sans registre partagé :
+    // les mutations se font en parallèle et le résultat ne dépend pas de l'ordre des threads.
+    // Les innovations ne sont pas chronologiques, la distance ne distingue pas gènes disjoints et en excès.
+    namespace neat
+    {
+        inline uint64_t innovation(uint64_t in, uint64_t out) {
+            return util::mix64(util::mix64(in) ^ out);
+        }
+
+        // bit de poids fort à 1 : les noeuds cachés sont triés après les entrées (0 .. ninput) et les sorties
+        inline uint64_t splitNode(uint64_t innovation, unsigned k) {
+            return util::mix64(innovation + k) | (1ull << 63);
+        }
+
+        struct NodeGene
+        {
+            uint64_t id;
+            activation_t activation;
+        };
+
+        struct ConnectionGene
+        {
+            uint64_t innovation;
+            uint64_t in;
+            uint64_t out;
+            bool enabled;
+        };
+
+        // Ce qui est commun à tous les génomes d'une population, partagé comme Topology
+        struct Config
+        {
+            size_t ninput;
+            size_t noutput;
+
+            activation_t input_activation;
+            activation_t hidden_activation;
+            activation_t output_activation;
+
+            double add_node_rate;
+            double add_connection_rate;
+
+            Config(NeuralParameters const &params);
+        };
+    } // namespace neat
+
+    // Génome NEAT : noeuds et connexions, sans couches. La topologie part du minimum (entrées reliées aux sorties)
+    // et grandit par mutation. Le réseau reste acyclique.
+    // Les noeuds sont triés par identifiant (entrées, sorties, puis cachés), les connexions par innovation :
+    // l'alignement de deux génomes est un parcours linéaire.
+    // Comme BasicNeuralNetwork, les valeurs sont dans un seul buffer params() : le poids de chaque connexion
+    // (dans l'ordre des connexions) puis le biais de chaque noeud non entrée (dans l'ordre des noeuds).
+    // Utilisable avec BasicPopulation et BasicGame, la population spécie les génomes (voir BasicSpeciation).
+    // Pas avec BasicIslands ni les points de reprise, qui ne transportent que params() (voir FixedTopology).
+    template <typename Scalar>
+    class BasicNeatNetwork
+    {
+    private:
+        std::shared_ptr<neat::Config const> m_config;
+
+        std::vector<neat::NodeGene> m_nodes;
+        std::vector<neat::ConnectionGene> m_connections;
+        std::vector<Scalar> m_params;
+
+        // plan compilé pour la structure m_planned, valeurs liées pour l'empreinte m_bound
+        BasicExecutionPlan<Scalar> m_plan;
+        bool m_compiled;
+        uint64_t m_planned;
+        uint64_t m_bound;
+        size_t m_output;
+
+        double m_score;
+        uint64_t m_structure; // empreinte des gènes, hors poids et biais
+        uint64_t m_hash;      // m_structure + empreinte de params()
+
+        size_t index(uint64_t id) const; // position du noeud id dans m_nodes, m_nodes.size() s'il n'existe pas
+        size_t connection(uint64_t innovation) const;
+
+        // successeurs de chaque noeud par connexion active ou non, en CSR : noeud i -> targets[first[i] .. first[i + 1])
+        void adjacency(std::vector<uint32_t> &first, std::vector<uint32_t> &targets) const;
+        static bool reaches(std::vector<uint32_t> const &first, std::vector<uint32_t> const &targets, size_t from, size_t to); // chemin de from à to
+
+        void insertConnection(uint64_t in, uint64_t out, Scalar weight);
+        bool addConnection(util::Random &rng);
+        bool addNode(util::Random &rng);
+
+        void hashStructure();
+
+        void prepare(); // recompile le plan si la structure a changé, relie les valeurs si seuls les poids ont changé
+
+    public:
+        using scalar_type = Scalar;
+
+        double m_fitness;
+
+        BasicNeatNetwork(NeuralParameters const &params);
+        BasicNeatNetwork(NeuralParameters const &params, util::Random &rng);
+
+        neat::Config const &config() const {
+            return *m_config;
+        }
+
+        std::vector<neat::NodeGene> const &nodes() const {
+            return m_nodes;
+        }
+
+        std::vector<neat::ConnectionGene> const &connections() const {
+            return m_connections;
+        }
+
+        util::Span<Scalar> params() {
+            return m_params;
+        }
+
+        util::Span<Scalar const> params() const {
+            return m_params;
+        }
+
+        Scalar weight(size_t connection) const {
+            return m_params[connection];
+        }
+
+        Scalar bias(size_t node) const {
+            return m_params[m_connections.size() + node - m_config->ninput];
+        } // node >= ninput
+
+        size_t compute(std::vector<Scalar> const &inputs) {
+            return compute(util::Span<Scalar const>(inputs));
+        } //lance le calcul du nn
+
+        size_t compute(Scalar const *inputs, size_t n) {
+            return compute(util::Span<Scalar const>(inputs, n));
+        }
+
+        size_t compute(util::Span<Scalar const> inputs);
+        size_t compute(util::Span<Scalar const> inputs, util::Span<Scalar> outputs); // copie les activations de sortie dans outputs
+
+        size_t computeArgmax(util::Span<Scalar const> inputs) {
+            return compute(inputs);
+        }
+
+        size_t computeArgmax(Scalar const *inputs, size_t n) {
+            return compute(util::Span<Scalar const>(inputs, n));
+        }
+
+        size_t output() const {
+            return m_output;
+        } //va chercher le résultat du calcul
+
+        BasicExecutionPlan<Scalar> const &plan() {
+            prepare();
+            return m_plan;
+        }
+
+        void score(double score) {
+            m_score = score;
+        } // set le score d'un nn
+
+        double score() const {
+            return m_score;
+        }
+
+        inline void fitness(double fitness) {
+            m_fitness = fitness;
+        } // set le fitness d'un nn
+
+        double fitness() const {
+            return m_fitness;
+        }
+
+        // Empreinte des gènes et des valeurs, tenue à jour par crossover et mutate.
+        // Après une modification directe de params(), appeler rehash().
+        uint64_t hash() const {
+            return m_hash;
+        }
+
+        uint64_t structureHash() const {
+            return m_structure;
+        } // ne change qu'avec une mutation structurelle ou un croisement
+
+        void rehash();
+
+        // Croisement NEAT : les gènes sont alignés par innovation, un gène apparié vient d'un parent au hasard,
+        // les autres viennent du parent au meilleur score (first à égalité). Un gène désactivé chez un parent
+        // l'est chez l'enfant avec une probabilité 3/4. type et crossover_rate sont ignorés.
+        void crossover(BasicNeatNetwork const &first, BasicNeatNetwork const &second, crossover_t type, double const crossover_rate, util::Random &rng);
+
+        void mutate(double const mutation_rate); //mute un nn
+        // perturbe les poids et biais comme BasicNeuralNetwork, puis ajoute une connexion et un noeud
+        // avec les probabilités add_connection_rate et add_node_rate
+        void mutate(double const mutation_rate, util::Random &rng, double const sigma = 0.05);
+
+        // Distance de compatibilité : disjoint * (gènes non appariés) / (taille du plus grand) + weight * (écart moyen des poids appariés).
+        // Un seul parcours des deux listes triées, arrêté dès que la distance dépasse limit.
+        static double distance(BasicNeatNetwork const &first, BasicNeatNetwork const &second, double disjoint, double weight,
+                               double limit = std::numeric_limits<double>::infinity());
+    };
+
+    using NeatNetwork = BasicNeatNetwork<double>;
+    using NeatNetworkf = BasicNeatNetwork<float>;
+
+    // Spéciation et partage de fitness : chaque génome rejoint la première espèce dont le représentant est à une
+    // distance inférieure au seuil, son score est divisé par la taille de son espèce.
+    // Les représentants sont gardés sous forme compacte (innovations et poids contigus) d'une génération à l'autre,
+    // l'espèce du génome précédent dans la liste est essayée en premier et les génomes identiques (même empreinte)
+    // réutilisent l'espèce déjà trouvée : les clones et les élites ne coûtent rien.
+    template <typename Scalar>
+    class BasicSpeciation
+    {
+    public:
+        struct Species
+        {
+            uint64_t id;
+            size_t size;  // génomes de la dernière génération
+            double best;  // meilleur score brut
+            size_t age;   // générations depuis la création
+
+            // représentant : génome compact
+            std::vector<uint64_t> innovations;
+            std::vector<Scalar> weights;
+        };
+
+    private:
+        double m_disjoint;
+        double m_weight;
+        double m_threshold;
+
+        std::vector<Species> m_species;
+        std::vector<uint32_t> m_assignment; // espèce de chaque génome
+        std::unordered_map<uint64_t, uint32_t> m_known; // empreinte -> espèce, pour la génération en cours
+        uint64_t m_next_id;
+        size_t m_comparisons; // distances calculées à la dernière génération
+
+        double distance(BasicNeatNetwork<Scalar> const &genome, Species const &species) const;
+        static void represent(Species &species, BasicNeatNetwork<Scalar> const &genome); // copie compacte du génome
+
+    public:
+        BasicSpeciation(NeuralParameters const &params);
+
+        // range chaque génome dans une espèce et écrit shared[i] = scores[i] / taille de son espèce
+        void assign(util::Span<BasicNeatNetwork<Scalar> const *const> genomes, util::Span<double const> scores, util::Span<double> shared);
+
+        std::vector<Species> const &species() const {
+            return m_species;
+        }
+
+        size_t speciesOf(size_t genome) const {
+            return m_assignment.at(genome);
+        } // indice dans species()
+
+        size_t comparisons() const {
+            return m_comparisons;
+        }
+    };
+
+    using Speciation = BasicSpeciation<double>;
+    using Speciationf = BasicSpeciation<float>;
+
+    // La population applique la spéciation avant chaque sélection
+    template <typename Scalar>
+    struct FitnessSharing<BasicNeatNetwork<Scalar>>
+    {
+        static constexpr bool enabled = true;
+
+        BasicSpeciation<Scalar> speciation;
+
+        FitnessSharing(NeuralParameters const &params) : speciation(params) {}
+
+        void operator()(util::Span<BasicNeatNetwork<Scalar> const *const> networks, util::Span<double const> scores, util::Span<double> shared) {
+            speciation.assign(networks, scores, shared);
+        }
+    };
+
+    extern template class BasicNeatNetwork<float>;
+    extern template class BasicNeatNetwork<double>;
+    extern template class BasicSpeciation<float>;
+    extern template class BasicSpeciation<double>;
+
+} // namespace neuralnetwork
@@ -1,118 +1,237 @@
 #pragma once
 
+#include <functional>
 #include <iostream>
+#include <stdexcept>
 #include <vector>
 
 #include <memory>
 
+#include "neural_network/activation.hpp"
+#include "neural_network/crossover.hpp"
+#include "neural_network/selection.hpp"
+#include "utils/random.hpp"
+#include "utils/span.hpp"
+
 namespace neuralnetwork
 {
 
+    // Toute la pile est paramétrée par le type scalaire (float ou double),
+    // les deux versions sont instanciées dans neural_network.cpp et batch.cpp.
+
+    // Tirages sans flux imposé, dans le générateur du thread appelant (util::threadRandom).
+    // La reproduction tire dans des flux util::Random dérivés de NeuralParameters::seed.
+    double rand_gen();     // tirage uniforme dans ]0, 1]
+    double normalRandom(); // tirage selon une loi normale centrée réduite
+
     //
-    class Layer
+    struct NeuralParameters
+    {
+        unsigned int nhiddenlayer;
+        unsigned int ninput;
+        unsigned int nhidden;
+        unsigned int noutput;
+        double crossover_rate;
+        double mutation_rate;
+        double mutation_sigma = 0.05; // écart type des perturbations
+        unsigned elitism = 0;         // nombre de meilleurs réseaux gardés tels quels à chaque génération
+        size_t fitness_cache = 4096;  // scores gardés par empreinte de génome pour les jeux déterministes, 0 : désactivé
+        unsigned top_k = 10;          // meilleurs réseaux suivis pendant l'évaluation, au moins elitism
+
+        uint64_t seed = 0; // graine des tirages de la reproduction, voir BasicPopulation::evolve
+
+        crossover_t crossover = crossover_t::OnePoint; // opérateur de croisement, voir crossover.hpp
+
+        // choix des parents, voir selection.hpp
+        selection_t selection = selection_t::Roulette;
+        unsigned tournament_size = 3;
+
+        // activation de chaque couche, voir activation.hpp
+        activation_t input_activation = activation_t::Sigmoid;
+        activation_t hidden_activation = activation_t::Sigmoid;
+        activation_t output_activation = activation_t::Sigmoid;
+
+        // BasicNeatNetwork et sa spéciation, voir neat.hpp
+        double add_node_rate = 0.03;          // probabilité d'ajouter un noeud à chaque mutation
+        double add_connection_rate = 0.05;    // probabilité d'ajouter une connexion à chaque mutation
+        double compatibility_disjoint = 1.0;  // poids des gènes non appariés dans la distance
+        double compatibility_weight = 0.4;    // poids de l'écart moyen des poids appariés
+        double compatibility_threshold = 3.0; // distance au-delà de laquelle deux génomes sont d'espèces différentes
+    };
+
+    // Description d'un réseau, partagée par tous les réseaux construits avec les mêmes paramètres.
+    // Tous les poids et biais d'un réseau sont dans un seul buffer : pour chaque couche l >= 1,
+    // les poids (neurone i, entrée j en i * sizes[l - 1] + j) puis les biais.
+    struct Topology
+    {
+        std::vector<size_t> sizes;          // taille de chaque couche, entrée comprise
+        std::vector<size_t> param_offsets;  // début des poids de chaque couche, biais à la suite
+        std::vector<size_t> neuron_offsets; // début des neurones de chaque couche
+        std::vector<activation_t> activations;
+
+        size_t nparams;
+        size_t nneurons;
+
+        Topology(NeuralParameters const &params);
+
+        size_t nweights(size_t layer) const {
+            return layer == 0 ? 0 : sizes[layer] * sizes[layer - 1];
+        }
+
+        size_t nbias(size_t layer) const {
+            return layer == 0 ? 0 : sizes[layer];
+        }
+
+        bool operator==(Topology const &other) const;
+        bool operator!=(Topology const &other) const {
+            return !(*this == other);
+        }
+    };
+
+    // Vue non propriétaire sur une couche d'un réseau : ses neurones dans le buffer d'activations,
+    // ses poids et biais dans le buffer de paramètres.
+    template <typename Scalar>
+    class BasicLayer
     {
     private:
-        std::vector<double> m_neurons;
-        std::vector<double> m_bias;
-        std::vector<double> m_weights;
+        Scalar *m_neurons;
+        Scalar *m_weights;
+        Scalar *m_bias;
+
+        size_t m_size;
+        size_t m_inputs;
 
-        void initWeigth(int previousLayerSize); // initialise les poids
-        //void initBias();
+        activation_t m_activation;
 
     public:
-        Layer(int neurons, Layer *previous_layer = nullptr);
-
-        Layer(Layer const &other);
-        Layer(Layer&& other);
+        using scalar_type = Scalar;
 
-        Layer &operator=(Layer const &other);
-        Layer &operator=(Layer &&other);
+        BasicLayer(Scalar *neurons, Scalar *params, size_t size, size_t inputs, activation_t activation);
 
-        double const &operator[](unsigned int index) const
+        Scalar const &operator[](unsigned int index) const
         {
             return m_neurons[index];
         }
 
-        double &operator[](unsigned int index)
+        Scalar &operator[](unsigned int index)
         {
             return m_neurons[index];
         }
 
-        //void init();
-        void compute(Layer const &previous);
-        void compute(std::vector<double> const &inputs);
+        Scalar const *data() const
+        {
+            return m_neurons;
+        }
+
+        void compute(BasicLayer const &previous);
+        void computeLinear(BasicLayer const &previous); // sans activation
+        void compute(Scalar const *inputs);
+        void initWeigth();                       // initialise les poids
+        void initWeigth(util::Random &rng);      // initialise les poids, tirages dans rng
         void mutate(double const mutation_rate); //mute un nn
+        void mutate(double const mutation_rate, util::Random &rng, double const sigma = 0.05); //mute un nn, tirages dans rng
 
-        std::vector<double> &weights()
+        util::Span<Scalar> weights()
         {
-            return m_weights;
+            return {m_weights, m_size * m_inputs};
         }
 
-        std::vector<double> const &weights() const
+        util::Span<Scalar const> weights() const
         {
-            return m_weights;
+            return {m_weights, m_size * m_inputs};
         }
 
-        std::vector<double> &bias()
+        util::Span<Scalar> bias()
         {
-            return m_bias;
+            return {m_bias, m_inputs == 0 ? 0 : m_size};
         }
 
-        std::vector<double> const &bias() const
+        util::Span<Scalar const> bias() const
         {
-            return m_bias;
+            return {m_bias, m_inputs == 0 ? 0 : m_size};
         }
 
         size_t size() const
         {
-            return m_neurons.size();
+            return m_size;
         }
-    };
 
-    //
-    struct NeuralParameters
-    {
-        unsigned int nhiddenlayer;
-        unsigned int ninput;
-        unsigned int nhidden;
-        unsigned int noutput;
-        double crossover_rate;
-        double mutation_rate;
+        activation_t activation() const
+        {
+            return m_activation;
+        }
     };
 
     //
-    class NeuralNetwork
+    template <typename Scalar>
+    class BasicNeuralNetwork
     {
     private:
-        std::vector<Layer> m_layers;
+        std::shared_ptr<Topology const> m_topology;
 
-        size_t m_size;
+        std::vector<Scalar> m_params;  // tous les poids et biais
+        std::vector<Scalar> m_neurons; // activations, buffer de calcul
 
         double m_score;
-        
+        uint64_t m_hash; // empreinte des paramètres, voir genome_hash.hpp
+
+        void forward(Scalar const *inputs, bool output_activation);
 
     public:
+        using scalar_type = Scalar;
+        using layer_type = BasicLayer<Scalar>;
 
         double m_fitness;
 
-        NeuralNetwork(NeuralParameters const &params);
-        NeuralNetwork(NeuralNetwork const &other);
-        NeuralNetwork(NeuralNetwork&& other);
+        BasicNeuralNetwork(NeuralParameters const &params);
+        BasicNeuralNetwork(NeuralParameters const &params, util::Random &rng);
+        BasicNeuralNetwork(std::shared_ptr<Topology const> topology);
+        BasicNeuralNetwork(BasicNeuralNetwork const &shape, util::Span<Scalar const> params); // topologie de shape, valeurs params, sans tirage
+        BasicNeuralNetwork(BasicNeuralNetwork const &other);
+        BasicNeuralNetwork(BasicNeuralNetwork&& other);
 
-        NeuralNetwork &operator=(NeuralNetwork const &other);
-        NeuralNetwork &operator=(NeuralNetwork &&other);
+        template <typename Other>
+        explicit BasicNeuralNetwork(BasicNeuralNetwork<Other> const &other); // conversion de précision, ex : référence double d'un réseau float
 
-        Layer &operator[](size_t index) {
-            return m_layers[index];
+        BasicNeuralNetwork &operator=(BasicNeuralNetwork const &other);
+        BasicNeuralNetwork &operator=(BasicNeuralNetwork &&other);
+
+        layer_type operator[](size_t index);
+        layer_type const operator[](size_t index) const;
+
+        size_t size() const {
+            return m_topology->sizes.size();
+        } // nombre de couches, entrée comprise
+
+        Topology const &topology() const {
+            return *m_topology;
         }
 
-        Layer const &operator[](size_t index) const {
-            return m_layers[index];
+        std::shared_ptr<Topology const> const &sharedTopology() const {
+            return m_topology;
         }
 
-        //void init();
+        util::Span<Scalar> params() {
+            return m_params;
+        }
+
+        util::Span<Scalar const> params() const {
+            return m_params;
+        }
+
+        // Aucune des versions de compute n'alloue : les activations sont dans le buffer du réseau
+        size_t compute(std::vector<Scalar> const &inputs); //lance le calcul du nn
+        size_t compute(Scalar const *inputs, size_t n);
+        size_t compute(util::Span<Scalar const> inputs);
+        size_t compute(util::Span<Scalar const> inputs, util::Span<Scalar> outputs); // copie les activations de sortie dans outputs
+
+        // Ne calcule que l'argmax : l'activation de sortie est sautée quand elle est strictement croissante (Identity),
+        // les neurones de sortie contiennent alors les valeurs avant activation
+        size_t computeArgmax(util::Span<Scalar const> inputs);
+        size_t computeArgmax(Scalar const *inputs, size_t n) {
+            return computeArgmax(util::Span<Scalar const>(inputs, n));
+        }
 
-        size_t compute(std::vector<double> const &inputs); //lance le calcul du nn
         size_t output() const;                             //va chercher le résultat du calcul
 
         void score(double score) {
@@ -131,67 +250,156 @@ namespace neuralnetwork
             return m_fitness;
         }
 
-        void crossover(NeuralNetwork const &first, NeuralNetwork const &second, double const crossover_rate);
+        // Empreinte du contenu, tenue à jour par crossover et mutate.
+        // Après une modification directe (params(), couches), appeler rehash().
+        uint64_t hash() const {
+            return m_hash;
+        }
+
+        void rehash();
+
+        void crossover(BasicNeuralNetwork const &first, BasicNeuralNetwork const &second, double const crossover_rate);
+        void crossover(BasicNeuralNetwork const &first, BasicNeuralNetwork const &second, crossover_t type, double const crossover_rate, util::Random &rng);
         void mutate(double const mutation_rate); //mute un nn
+        void mutate(double const mutation_rate, util::Random &rng, double const sigma = 0.05); //mute un nn, tirages dans rng
     };
 
+    template <typename Scalar>
+    template <typename Other>
+    BasicNeuralNetwork<Scalar>::BasicNeuralNetwork(BasicNeuralNetwork<Other> const &other)
+        : m_topology(other.sharedTopology()),
+          m_params(other.params().begin(), other.params().end()),
+          m_neurons(other.topology().nneurons, 0),
+          m_score(other.score()),
+          m_hash(0),
+          m_fitness(other.fitness()) {
+        rehash();
+    }
+
     //
 
-    class Game
+    template <typename Network>
+    class BasicGame
     {
     public:
-        virtual bool operator()(NeuralNetwork &nn) = 0;
+        virtual ~BasicGame() = default;
+
+        virtual bool operator()(Network &nn) = 0;
+
+        // vrai si le score ne dépend que des paramètres du réseau :
+        // la population peut alors réutiliser le score d'un génome déjà évalué
+        virtual bool deterministic() const {
+            return false;
+        }
     };
 
-    //
-    class Population
+    // Crée un jeu par worker pour l'évaluation en parallèle : un jeu a un état,
+    // il ne peut pas être partagé entre threads
+    template <typename Network>
+    using BasicGameFactory = std::function<std::unique_ptr<BasicGame<Network>>()>;
+
+    // Moteur d'inférence de toute une population de même topologie.
+    // Les paramètres de tous les génomes sont stockés dans un seul buffer, entrelacés par génome :
+    // le paramètre p (indice dans le buffer d'un réseau) du génome g est à l'indice p * count + g,
+    // le neurone i du génome g à l'indice i * count + g.
+    // Une passe calcule les N réseaux en même temps, la boucle interne parcourt les génomes en continu.
+    template <typename Scalar>
+    class BasicBatchNetwork
     {
     private:
-        std::vector<NeuralNetwork> *m_curr_population;
-        std::vector<NeuralNetwork> *m_old_population;
+        std::shared_ptr<Topology const> m_topology;
 
-        std::vector<NeuralNetwork> m_first_population;
-        std::vector<NeuralNetwork> m_second_population;
+        std::vector<Scalar> m_params;
+        std::vector<Scalar> m_neurons;
 
-        NeuralParameters m_params;
+        size_t m_count;
 
-        size_t m_size;
+    public:
+        using scalar_type = Scalar;
 
-        NeuralNetwork& pickOne(); //choisi un element aléatoire de la population
-        void calculateFitness();  //calcule la fitness de chaque element de la population
-        void evolve();            //copulation de toute la popolation
+        BasicBatchNetwork();
+        BasicBatchNetwork(std::vector<BasicNeuralNetwork<Scalar>> const &networks);
 
-    public:
-        Population(unsigned population_size, NeuralParameters const &params);
+        void load(std::vector<BasicNeuralNetwork<Scalar>> const &networks); //copie les paramètres, réutilise les buffers
+        void load(util::Span<BasicNeuralNetwork<Scalar> const *const> networks);
 
-        Population(Population const &other);
-        Population(Population&& other);
+        // inputs : une ligne de ninput valeurs par génome, outputs : l'argmax de chaque génome
+        void compute(Scalar const *inputs, size_t *outputs);
+        void compute(std::vector<Scalar> const &inputs, std::vector<size_t> &outputs);
+        void compute(util::Span<Scalar const> inputs, util::Span<size_t> outputs);
 
-        Population &operator=(Population const &other);
-        Population &operator=(Population&& other);
+        Scalar output(size_t genome, size_t neuron) const {
+            return m_neurons[(m_topology->neuron_offsets.back() + neuron) * m_count + genome];
+        }
 
-        void run(Game &game);
+        size_t size() const {
+            return m_count;
+        }
 
-        NeuralNetwork &bestElement();
-        NeuralNetwork const &bestElement() const;
+        size_t ninput() const {
+            return m_topology ? m_topology->sizes.front() : 0;
+        }
 
-        NeuralNetwork &operator[](size_t index) {
-            return m_curr_population->at(index);
+        size_t noutput() const {
+            return m_topology ? m_topology->sizes.back() : 0;
         }
+    };
 
-        NeuralNetwork const &operator[](size_t index) const {
-            return m_curr_population->at(index);
+    // Jeu évaluant toute la population d'un coup, écrit le score de chaque génome dans scores
+    template <typename Scalar>
+    class BasicBatchGame
+    {
+    public:
+        virtual ~BasicBatchGame() = default;
+
+        virtual void operator()(BasicBatchNetwork<Scalar> &networks, std::vector<double> &scores) = 0;
+
+        // comme BasicGame::deterministic : le batch ne contient alors que les génomes absents du cache
+        virtual bool deterministic() const {
+            return false;
         }
     };
 
-    //
-    class NeuralPrinter
+    // Vrai pour les réseaux dont la disposition des paramètres ne dépend que de NeuralParameters :
+    // params() suffit alors à décrire un génome (points de reprise, historique, migrations entre îles).
+    // Faux par défaut, notamment pour BasicNeatNetwork dont la structure évolue.
+    template <typename Network>
+    struct FixedTopology
     {
-        void printNetwork(NeuralNetwork const &nn); //affichage
-        void printPopulaton(Population const &pop); //print population
+        static constexpr bool value = false;
     };
 
+    template <typename Scalar>
+    struct FixedTopology<BasicNeuralNetwork<Scalar>>
+    {
+        static constexpr bool value = true;
+    };
+
+    // double : référence, float : moitié moins de mémoire et deux fois plus de lignes SIMD
+    using Layer = BasicLayer<double>;
+    using NeuralNetwork = BasicNeuralNetwork<double>;
+    using Game = BasicGame<NeuralNetwork>;
+    using GameFactory = BasicGameFactory<NeuralNetwork>;
+    using BatchNetwork = BasicBatchNetwork<double>;
+    using BatchGame = BasicBatchGame<double>;
+
+    using Layerf = BasicLayer<float>;
+    using NeuralNetworkf = BasicNeuralNetwork<float>;
+    using Gamef = BasicGame<NeuralNetworkf>;
+    using GameFactoryf = BasicGameFactory<NeuralNetworkf>;
+    using BatchNetworkf = BasicBatchNetwork<float>;
+    using BatchGamef = BasicBatchGame<float>;
+
+    extern template class BasicLayer<float>;
+    extern template class BasicLayer<double>;
+    extern template class BasicNeuralNetwork<float>;
+    extern template class BasicNeuralNetwork<double>;
+    extern template class BasicBatchNetwork<float>;
+    extern template class BasicBatchNetwork<double>;
+
 } // namespace neuralnetwork
+
+#include "neural_network/population.hpp"
   /*
 #define TAILLE_POPULATION 1000
 #define NB_INPUT 8
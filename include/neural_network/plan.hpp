@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "neural_network/activation.hpp"
+#include "utils/span.hpp"
+
+namespace neuralnetwork
+{
+
+    template <typename Scalar>
+    class BasicNeuralNetwork;
+
+    template <typename Scalar>
+    class BasicNeatNetwork;
+
+    // Plan d'exécution d'un réseau quelconque (graphe NEAT, MLP élagué) : une suite d'instructions dans l'ordre
+    // topologique, une par neurone calculé. Chaque neurone a une case fixe dans un tableau de valeurs
+    // (entrées d'abord), ses termes (case source, poids) sont contigus, et son activation est résolue à la compilation.
+    // Les neurones dont aucune sortie ne dépend ne sont pas compilés.
+    //
+    // La compilation ne dépend que de la structure ; bind recopie les poids et biais dans l'ordre d'exécution
+    // et suffit tant que la structure ne change pas.
+    template <typename Scalar>
+    class BasicExecutionPlan
+    {
+    private:
+        using function_type = Scalar (*)(Scalar);
+
+        struct Instruction
+        {
+            uint32_t slot; // case du résultat
+            uint32_t end;  // termes [fin de l'instruction précédente, end)
+            function_type activation;
+        };
+
+        size_t m_ninput;
+        activation_t m_input_activation;
+
+        std::vector<Instruction> m_code;
+        std::vector<uint32_t> m_sources;      // case source de chaque terme
+        std::vector<uint32_t> m_weight_index; // indice du poids de chaque terme dans params
+        std::vector<uint32_t> m_bias_index;   // indice du biais de chaque instruction dans params
+        std::vector<uint32_t> m_outputs;      // case de chaque sortie
+
+        std::vector<Scalar> m_weights; // valeurs liées par bind
+        std::vector<Scalar> m_biases;
+        std::vector<Scalar> m_values;  // une case par neurone, buffer de calcul
+
+        void reset(size_t ninput, activation_t input_activation);
+        void emit(uint32_t slot, uint32_t bias, activation_t activation); // termes ajoutés depuis l'instruction précédente
+
+    public:
+        BasicExecutionPlan() : m_ninput(0), m_input_activation(activation_t::Identity) {}
+
+        void compile(BasicNeatNetwork<Scalar> const &network);
+
+        // MLP élagué : les poids nuls au moment de la compilation sont retirés du plan
+        void compile(BasicNeuralNetwork<Scalar> const &network);
+
+        // recopie les valeurs de params (même disposition que le réseau compilé)
+        void bind(util::Span<Scalar const> params);
+
+        // calcule le réseau, copie les sorties dans outputs si fourni, renvoie l'argmax des sorties
+        size_t run(Scalar const *inputs, Scalar *outputs = nullptr);
+
+        size_t ninput() const {
+            return m_ninput;
+        }
+
+        size_t noutput() const {
+            return m_outputs.size();
+        }
+
+        size_t instructions() const {
+            return m_code.size();
+        }
+
+        size_t terms() const {
+            return m_sources.size();
+        }
+    };
+
+    using ExecutionPlan = BasicExecutionPlan<double>;
+    using ExecutionPlanf = BasicExecutionPlan<float>;
+
+    extern template class BasicExecutionPlan<float>;
+    extern template class BasicExecutionPlan<double>;
+
+} // namespace neuralnetwork
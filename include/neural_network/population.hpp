@@ -0,0 +1,581 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "neural_network/neural_network.hpp"
+#include "utils/lru_cache.hpp"
+#include "utils/scheduler.hpp"
+#include "utils/statistics.hpp"
+#include "utils/thread_pool.hpp"
+
+namespace neuralnetwork
+{
+
+    // Réutilisation des scores sur une génération
+    struct CacheStats
+    {
+        size_t hits = 0;   // réseaux dont le score vient du cache
+        size_t misses = 0; // réseaux évalués
+
+        double hitRate() const {
+            return hits + misses == 0 ? 0 : (double)hits / (hits + misses);
+        }
+    };
+
+    // Ajustement des scores avant la sélection, propre au type de réseau. Aucun par défaut,
+    // BasicNeatNetwork le spécialise pour la spéciation (voir neat.hpp).
+    template <typename Network>
+    struct FitnessSharing
+    {
+        static constexpr bool enabled = false;
+
+        FitnessSharing(NeuralParameters const &) {}
+
+        void operator()(util::Span<Network const *const>, util::Span<double const>, util::Span<double>) {}
+    };
+
+    // La population est générique sur le type de réseau (BasicNeuralNetwork, BasicStaticNeuralNetwork, ...),
+    // ses définitions sont donc dans ce header. Un réseau doit fournir
+    // un constructeur depuis (NeuralParameters, util::Random&), score / fitness, hash, crossover(first, second, type, rate, util::Random&) et mutate(rate, util::Random&, sigma).
+
+    //
+    template <typename Network>
+    class BasicPopulation
+    {
+    public:
+        using network_type = Network;
+        using scalar_type = typename Network::scalar_type;
+
+    private:
+        // 2 * m_size réseaux : la génération courante et la place des enfants.
+        // Les générations sont des tables d'indices dans m_pool, les réseaux ne sont jamais copiés ni déplacés.
+        std::vector<Network> m_pool;
+        std::vector<size_t> m_current; // réseau i de la génération courante : m_pool[m_current[i]]
+        std::vector<size_t> m_free;    // réseaux de m_pool hors génération courante, reçoivent les enfants
+        std::vector<size_t> m_next;
+        std::vector<size_t> m_order;   // élites puis liste libre suivante, voir evolve
+        std::vector<std::pair<size_t, size_t>> m_parents; // parents du réseau i dans la génération précédente
+        std::vector<std::pair<size_t, size_t>> m_next_parents;
+
+        NeuralParameters m_params;
+
+        size_t m_size;
+        uint64_t m_generation; // nombre d'appels a evolve, sert à dériver les flux aléatoires
+
+        BasicBatchNetwork<scalar_type> m_batch;
+        std::vector<Network const *> m_networks; // génération courante, pour le batch et le partage de fitness
+        std::vector<double> m_scores; // score du réseau i, rempli au fil de l'évaluation
+        std::vector<double> m_batch_scores; // score du génome k du batch, réseau m_pending[k]
+
+        FitnessSharing<Network> m_sharing;
+        std::vector<double> m_shared; // scores après partage, si FitnessSharing<Network>::enabled
+
+        Selection m_selection; // table de tirage des parents, reconstruite par calculateFitness
+
+        // statistiques de la génération évaluée, alimentées au fil des scores (cache compris)
+        util::Statistics m_stats;
+        std::vector<util::Statistics> m_worker_stats; // une par worker, fusionnées après l'évaluation
+        std::vector<size_t> m_best;                   // réseaux de m_stats.top() dans m_pool, du meilleur au moins bon
+
+        // scores par empreinte de génome, utilisés si le jeu est déterministe
+        util::LruCache<uint64_t, double> m_cache;
+        std::vector<size_t> m_pending; // réseaux de la génération à évaluer
+        CacheStats m_cache_stats;
+
+        std::vector<std::unique_ptr<BasicGame<Network>>> m_games; // un jeu par worker
+        util::WorkStealingScheduler m_scheduler;
+
+        // lecture en arrière-plan de la génération m_pin_generation, voir pin
+        std::function<void()> m_pin;
+        uint64_t m_pin_generation;
+
+        std::function<void(BasicPopulation &)> m_evaluated; // voir evaluated
+
+        size_t pickOne(util::Random &rng) const; //choisi un element aléatoire de la population, renvoie son indice
+        void calculateFitness();  //calcule la fitness de chaque element de la population, la table de sélection et m_best
+        void breed(size_t index); //crée l'enfant index de la génération suivante dans m_pool[m_next[index]]
+        void evolve(util::ThreadPool *pool = nullptr); //copulation de toute la popolation, répartie sur pool si fourni
+
+        void lookup(bool deterministic); //remplit m_pending, les autres réseaux reçoivent leur score du cache
+        void store(bool deterministic);  //garde le score des réseaux évalués
+
+        void unpin() {
+            if (m_pin) {
+                std::function<void()> wait = std::move(m_pin);
+                m_pin = nullptr;
+                wait();
+            }
+        } //attend la fin de la lecture en arrière-plan
+
+        void index(); // génération courante, liste libre et parents d'une population neuve, m_pool rempli
+
+        void record(size_t index, util::Statistics &stats) {
+            m_scores[index] = at(index).score();
+            stats.add(m_scores[index], index);
+        } //range le score du réseau index, stats est propre au thread appelant
+
+        Network &at(size_t index) {
+            return m_pool[m_current[index]];
+        }
+
+    public:
+        BasicPopulation(unsigned population_size, NeuralParameters const &params);
+
+        // Population de génomes existants (ex : loadCheckpoint), aucun poids tiré : le réseau i est make(i),
+        // les réseaux qui recevront les enfants sont des copies de la génération courante
+        BasicPopulation(unsigned population_size, NeuralParameters const &params, std::function<Network(size_t)> const &make);
+
+        BasicPopulation(BasicPopulation const &other);
+        BasicPopulation(BasicPopulation&& other);
+
+        BasicPopulation &operator=(BasicPopulation const &other);
+        BasicPopulation &operator=(BasicPopulation&& other);
+
+        ~BasicPopulation() {
+            unpin();
+        }
+
+        void run(BasicGame<Network> &game);
+        void run(BasicBatchGame<scalar_type> &game); //évalue en une passe les réseaux absents du cache
+
+        // Évalue la population sur tous les workers de pool, chacun avec son propre jeu créé par factory.
+        // Les réseaux sont répartis par vol de travail : les parties de durée très variable n'attendent pas le plus lent.
+        // Même résultat que run(Game&) tant que le score d'un réseau ne dépend que de ce réseau.
+        void run(BasicGameFactory<Network> const &factory, util::ThreadPool &pool);
+
+        util::SchedulerStats const &schedulerStats() const {
+            return m_scheduler.stats();
+        } // répartition de la charge du dernier run parallèle
+
+        void schedulerChunk(size_t chunk) {
+            m_scheduler.chunk(chunk);
+        } // nombre de réseaux par bloc volable, 0 : automatique
+
+        CacheStats const &cacheStats() const {
+            return m_cache_stats;
+        } // succès du cache de scores sur la dernière génération évaluée
+
+        FitnessSharing<Network> const &fitnessSharing() const {
+            return m_sharing;
+        } // ex : espèces d'une population de BasicNeatNetwork
+
+        util::Statistics const &stats() const {
+            return m_stats;
+        } // min, max, moyenne, variance, quantiles et meilleurs scores de la dernière génération évaluée
+
+        // Meilleur réseau de la dernière génération évaluée, en O(1) : il reste dans m_pool jusqu'au prochain evolve.
+        // Avant la première évaluation, le premier réseau.
+        Network &bestElement();
+        Network const &bestElement() const;
+
+        Network const &top(size_t rank) const {
+            return m_pool[m_best.at(rank)];
+        } // rank-ième meilleur réseau de la dernière génération évaluée, rank < topSize()
+
+        size_t topSize() const {
+            return m_best.size();
+        }
+
+        Network &operator[](size_t index) {
+            return m_pool.at(m_current.at(index));
+        }
+
+        Network const &operator[](size_t index) const {
+            return m_pool.at(m_current.at(index));
+        }
+
+        size_t size() const {
+            return m_size;
+        }
+
+        // indices dans la génération précédente des parents du réseau index (une élite est son propre parent),
+        // (index, index) avant le premier evolve
+        std::pair<size_t, size_t> parents(size_t index) const {
+            return m_parents.at(index);
+        }
+
+        NeuralParameters const &parameters() const {
+            return m_params;
+        }
+
+        uint64_t generation() const {
+            return m_generation;
+        } // nombre de générations produites
+
+        void generation(uint64_t generation) {
+            m_generation = generation;
+        } // reprise d'une population restaurée : les flux de la reproduction dépendent de la génération
+
+        void forget() {
+            m_stats.clear();
+            m_best.clear();
+        } // oublie la dernière évaluation, ex : génomes recopiés d'un autre processus. bestElement() revient au premier réseau
+
+        // Une tâche en arrière-plan lit la génération courante en place (ex : BasicCheckpointer).
+        // Ses réseaux ne sont pas modifiés par le run suivant, seulement réutilisés pour les enfants de celui d'après :
+        // evolve appelle wait avant, puis oublie la tâche. Les modifications directes (operator[]) ne sont pas protégées.
+        void pin(std::function<void()> wait) {
+            unpin();
+            m_pin = std::move(wait);
+            m_pin_generation = m_generation;
+        }
+
+        // Appelé par run entre l'évaluation et evolve : la génération courante est alors celle qui vient d'être jouée,
+        // chaque réseau porte son propre score (ex : saveCheckpoint, Checkpointer::save, CheckpointHistory::record).
+        // Entre deux runs, les enfants ne sont pas encore évalués et leur score vaut NaN.
+        // Les réseaux ne doivent pas y être modifiés ; non copié avec la population.
+        void evaluated(std::function<void(BasicPopulation &)> callback) {
+            m_evaluated = std::move(callback);
+        }
+    };
+
+    using Population = BasicPopulation<NeuralNetwork>;
+    using Populationf = BasicPopulation<NeuralNetworkf>;
+
+    //////////////////////////////////////////////////////////////////////////////////////////////////
+    /////                                     Population                                         /////
+    //////////////////////////////////////////////////////////////////////////////////////////////////
+    
+    template <typename Network>
+    size_t BasicPopulation<Network>::pickOne(util::Random &rng) const{
+        return m_selection.pick(rng);
+    }
+
+
+    template <typename Network>
+    void BasicPopulation<Network>::calculateFitness(){
+        // les scores sont déjà rangés dans m_scores, la table de tirage en fait la somme :
+        // tirer selon les scores ou selon les fitness normalisées revient au même
+        util::Span<double const> scores = m_scores;
+
+        if constexpr (FitnessSharing<Network>::enabled) {
+            m_networks.resize(m_size);
+            for (size_t i = 0; i < m_size; i++)
+                m_networks[i] = &at(i);
+
+            m_shared.resize(m_size);
+            m_sharing(m_networks, m_scores, m_shared);
+            scores = m_shared;
+        }
+
+        m_selection.build(scores);
+        double sum = m_selection.total();
+
+        for( size_t i = 0; i < m_size; i++)
+            at(i).fitness(scores[i] / sum);
+
+        // classement tenu pendant l'évaluation
+        std::vector<util::TopK::Entry> const &top = m_stats.top().entries();
+
+        m_best.resize(top.size());
+        for (size_t i = 0; i < top.size(); i++)
+            m_best[i] = m_current[top[i].id];
+    }
+
+
+    template <typename Network>
+    void BasicPopulation<Network>::lookup(bool deterministic){
+        m_pending.clear();
+        m_cache_stats = CacheStats();
+
+        m_stats.clear();
+        m_scores.resize(m_size);
+
+        bool use_cache = deterministic && m_cache.capacity() > 0;
+
+        for (size_t i = 0; i < m_size; i++) {
+            double score;
+
+            if (use_cache && m_cache.find(at(i).hash(), score)) {
+                at(i).score(score);
+                record(i, m_stats);
+                m_cache_stats.hits++;
+            } else {
+                m_pending.push_back(i);
+            }
+        }
+
+        if (use_cache)
+            m_cache_stats.misses = m_pending.size();
+    }
+
+    template <typename Network>
+    void BasicPopulation<Network>::store(bool deterministic){
+        if (!deterministic || m_cache.capacity() == 0)
+            return;
+
+        for (size_t i : m_pending)
+            m_cache.insert(at(i).hash(), at(i).score());
+    }
+
+    template <typename Network>
+    void BasicPopulation<Network>::breed(size_t index){
+        // chaque enfant a son propre flux : le résultat ne dépend ni de l'ordre ni du thread de calcul
+        util::Random rng = util::Random::stream(m_params.seed, m_generation, index);
+
+        size_t const first = pickOne(rng);
+        size_t const second = pickOne(rng);
+        m_next_parents[index] = {first, second};
+
+        Network& tmp = m_pool[m_next[index]];
+        tmp.crossover(m_pool[m_current[first]], m_pool[m_current[second]], m_params.crossover, m_params.crossover_rate, rng);
+        tmp.mutate(m_params.mutation_rate, rng, m_params.mutation_sigma);
+        tmp.score(std::numeric_limits<double>::quiet_NaN()); // pas encore évalué, la place gardait le score d'un ancien réseau
+    }
+
+    template <typename Network>
+    void BasicPopulation<Network>::evolve(util::ThreadPool *pool){
+        // les élites (meilleurs scores, à égalité le plus petit indice) viennent du classement de m_stats
+        // et passent par leur indice, sans copie. m_order[i] vaut 1 si le réseau i est une élite
+        std::vector<util::TopK::Entry> const &top = m_stats.top().entries();
+        size_t const elites = std::min<size_t>(m_params.elitism, top.size());
+
+        // m_free contient les réseaux de la génération précédente
+        if (m_pin && m_pin_generation < m_generation)
+            unpin();
+
+        m_order.assign(m_size, 0);
+        m_next.resize(m_size);
+        m_next_parents.resize(m_size);
+
+        for (size_t i = 0; i < elites; i++) {
+            m_next[i] = m_current[top[i].id];
+            m_next_parents[i] = {top[i].id, top[i].id};
+            m_order[top[i].id] = 1;
+        }
+        for (size_t i = elites; i < m_size; i++)
+            m_next[i] = m_free[i - elites];
+
+        size_t const children = m_size - elites;
+
+        if (pool == nullptr || pool->size() <= 1) {
+            for (size_t i = elites; i < m_size; i++)
+                breed(i);
+        } else {
+            // coût identique pour chaque enfant : un découpage statique suffit
+            size_t nworkers = pool->size();
+
+            pool->run([&](size_t worker) {
+                size_t begin = elites + children * worker / nworkers;
+                size_t end = elites + children * (worker + 1) / nworkers;
+
+                for (size_t i = begin; i < end; i++)
+                    breed(i);
+            });
+        }
+
+        // libres : les non élites de la génération courante et les places qui n'ont pas servi.
+        // La liste est écrite en place dans m_order, jamais au-delà de la marque lue
+        size_t count = 0;
+        for (size_t i = 0; i < m_size; i++)
+            if (!m_order[i])
+                m_order[count++] = m_current[i];
+        for (size_t i = children; i < m_size; i++)
+            m_order[i] = m_free[i];
+
+        m_free.swap(m_order);
+        m_current.swap(m_next);
+        m_parents.swap(m_next_parents);
+
+        m_generation++;
+    }
+
+
+    template <typename Network>
+    BasicPopulation<Network>::BasicPopulation(unsigned population_size, NeuralParameters const &params)
+        : m_params(params), m_size(population_size), m_generation(0), m_sharing(params),
+          m_selection(params.selection, params.tournament_size), m_stats(std::max(params.top_k, params.elitism)),
+          m_cache(params.fitness_cache), m_pin_generation(0) {
+        // flux réservé à l'initialisation, hors de ceux des générations
+        util::Random rng = util::Random::stream(params.seed, UINT32_MAX, 0);
+        Network buffer(params, rng);
+
+        m_pool.resize(2 * population_size, buffer);
+        index();
+    }
+
+    template <typename Network>
+    BasicPopulation<Network>::BasicPopulation(unsigned population_size, NeuralParameters const &params, std::function<Network(size_t)> const &make)
+        : m_params(params), m_size(population_size), m_generation(0), m_sharing(params),
+          m_selection(params.selection, params.tournament_size), m_stats(std::max(params.top_k, params.elitism)),
+          m_cache(params.fitness_cache), m_pin_generation(0) {
+        m_pool.reserve(2 * population_size);
+
+        for (size_t i = 0; i < population_size; i++)
+            m_pool.push_back(make(i));
+        for (size_t i = 0; i < population_size; i++)
+            m_pool.push_back(m_pool[i]);
+
+        index();
+    }
+
+    template <typename Network>
+    void BasicPopulation<Network>::index(){
+        m_current.resize(m_size);
+        m_free.resize(m_size);
+
+        std::iota(m_current.begin(), m_current.end(), 0);
+        std::iota(m_free.begin(), m_free.end(), m_size);
+
+        m_parents.resize(m_size);
+        for (size_t i = 0; i < m_size; i++)
+            m_parents[i] = {i, i};
+    }
+
+    // m_sharing n'a pas de constructeur par défaut : construit vide depuis les paramètres, son état vient de operator=
+    template <typename Network>
+    BasicPopulation<Network>::BasicPopulation(BasicPopulation const &other) : m_sharing(other.m_params), m_pin_generation(0) {
+        *this = other;
+    }
+
+    template <typename Network>
+    BasicPopulation<Network>::BasicPopulation(BasicPopulation&& other) : m_sharing(other.m_params), m_pin_generation(0) {
+        *this = std::move(other);
+    }
+
+    template <typename Network>
+    BasicPopulation<Network> &BasicPopulation<Network>::operator=(BasicPopulation const &other) {
+        unpin();
+
+        m_pool = other.m_pool;
+        m_current = other.m_current;
+        m_free = other.m_free;
+        m_parents = other.m_parents;
+
+        m_params = other.m_params;
+        m_size = other.m_size;
+        m_generation = other.m_generation;
+        m_selection = other.m_selection;
+        m_cache = other.m_cache;
+        m_sharing = other.m_sharing;
+        m_stats = other.m_stats;
+        m_best = other.m_best;
+        return *this;
+    }
+
+    template <typename Network>
+    BasicPopulation<Network> &BasicPopulation<Network>::operator=(BasicPopulation&& other) {
+        unpin();
+        other.unpin();
+
+        m_pool = std::move(other.m_pool);
+        m_current = std::move(other.m_current);
+        m_free = std::move(other.m_free);
+        m_parents = std::move(other.m_parents);
+
+        m_params = other.m_params;
+        m_size = other.m_size;
+        m_generation = other.m_generation;
+        m_selection = std::move(other.m_selection);
+        m_cache = std::move(other.m_cache);
+        m_sharing = std::move(other.m_sharing);
+        m_stats = std::move(other.m_stats);
+        m_best = std::move(other.m_best);
+        return *this;
+    }
+
+    template <typename Network>
+    void BasicPopulation<Network>::run(BasicGame<Network> &game){
+        bool deterministic = game.deterministic();
+        lookup(deterministic);
+
+        for (size_t i : m_pending) {
+            game(at(i));
+            record(i, m_stats);
+        }
+
+        store(deterministic);
+        calculateFitness();
+        if (m_evaluated)
+            m_evaluated(*this);
+        evolve();
+    }
+
+    template <typename Network>
+    void BasicPopulation<Network>::run(BasicBatchGame<scalar_type> &game){
+        bool deterministic = game.deterministic();
+        lookup(deterministic);
+
+        // seuls les réseaux sans score en cache passent dans le batch
+        if (!m_pending.empty()) {
+            m_networks.resize(m_pending.size());
+            for (size_t k = 0; k < m_pending.size(); k++)
+                m_networks[k] = &at(m_pending[k]);
+
+            m_batch.load(m_networks);
+            m_batch_scores.assign(m_pending.size(), 0);
+
+            game(m_batch, m_batch_scores);
+
+            for (size_t k = 0; k < m_pending.size(); k++) {
+                at(m_pending[k]).score(m_batch_scores[k]);
+                record(m_pending[k], m_stats);
+            }
+        }
+
+        store(deterministic);
+        calculateFitness();
+        if (m_evaluated)
+            m_evaluated(*this);
+        evolve();
+    }
+
+    template <typename Network>
+    void BasicPopulation<Network>::run(BasicGameFactory<Network> const &factory, util::ThreadPool &pool){
+        // les jeux sont créés ici, la factory n'a pas besoin d'être thread-safe
+        m_games.clear();
+        for (size_t i = 0; i < pool.size(); i++)
+            m_games.push_back(factory());
+
+        bool deterministic = m_games.front()->deterministic();
+        lookup(deterministic);
+
+        // chaque worker accumule ses statistiques seul, la fusion ne dépend pas de la répartition
+        // (à l'arrondi près pour la moyenne et la variance)
+        m_worker_stats.assign(pool.size(), util::Statistics(m_stats.top().capacity(), m_stats.quantiles().accuracy()));
+
+        m_scheduler.run(pool, m_pending.size(), [&](size_t worker, size_t i) {
+            (*m_games[worker])(at(m_pending[i]));
+            record(m_pending[i], m_worker_stats[worker]);
+        });
+
+        for (util::Statistics const &stats : m_worker_stats)
+            m_stats.merge(stats);
+
+        store(deterministic);
+
+        // chaque enfant tire dans son propre flux : même génération suivante que run(Game&)
+        calculateFitness();
+        if (m_evaluated)
+            m_evaluated(*this);
+        evolve(&pool);
+    }
+
+    template <typename Network>
+    Network &BasicPopulation<Network>::bestElement(){
+        return m_best.empty() ? at(0) : m_pool[m_best.front()];
+    }
+
+    template <typename Network>
+    Network const &BasicPopulation<Network>::bestElement() const{
+        return m_best.empty() ? m_pool[m_current[0]] : m_pool[m_best.front()];
+    }
+
+    extern template class BasicPopulation<NeuralNetworkf>;
+    extern template class BasicPopulation<NeuralNetwork>;
+
+    //
+    class NeuralPrinter
+    {
+        void printNetwork(NeuralNetwork const &nn); //affichage
+        void printPopulaton(Population const &pop); //print population
+    };
+
+} // namespace neuralnetwork
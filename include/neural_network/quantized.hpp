@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "neural_network/activation.hpp"
+#include "neural_network/neural_network.hpp"
+#include "utils/span.hpp"
+
+namespace neuralnetwork
+{
+
+    // quantification symétrique d'une ligne de poids : le plus grand |w| vaut ±127, renvoie l'échelle (w = scale * q)
+    template <typename Scalar>
+    float quantizeRow(Scalar const *weights, size_t n, int8_t *out) {
+        double max = 0;
+        for (size_t j = 0; j < n; j++)
+            max = std::max(max, std::fabs((double)weights[j]));
+
+        double scale = max / 127;
+        for (size_t j = 0; j < n; j++)
+            out[j] = scale == 0 ? 0 : (int8_t)std::clamp(std::lround(weights[j] / scale), -127l, 127l);
+
+        return scale;
+    }
+
+    // Copie int8 d'un réseau entraîné, pour les phases qui ne font qu'évaluer (tournois, validation sur de nombreuses graines).
+    // Poids : une échelle par neurone, w = scale * q avec q dans [-127, 127].
+    // Activations : requantifiées à chaque couche et à chaque calcul sur leur minimum et leur maximum,
+    // x = min + scale * q avec q dans [0, 127]. Le produit est entier (kernels::dotInt8), biais et activation en float.
+    // Les paramètres sont figés à la construction : reconstruire après une mutation.
+    class QuantizedNetwork
+    {
+    private:
+        struct Layer
+        {
+            size_t size;
+            size_t inputs;
+            size_t stride;   // valeurs par ligne de poids, multiple de 32
+            size_t weights;  // début des poids dans m_weights
+            size_t neurons;  // début des échelles, sommes et biais de la couche
+            activation_t activation;
+        };
+
+        std::vector<Layer> m_layers; // couche 0 : entrée
+
+        std::vector<int8_t> m_weights; // lignes complétées par des zéros
+        std::vector<float> m_scales;   // échelle de chaque ligne
+        std::vector<int32_t> m_sums;   // somme des poids quantifiés de chaque ligne, pour le terme min * somme_j w
+        std::vector<float> m_bias;
+
+        // buffers de calcul
+        std::vector<float> m_current;
+        std::vector<float> m_next;
+        std::vector<uint8_t> m_quantized;
+        std::vector<int32_t> m_dot;
+
+        size_t m_output;
+
+        size_t forward();
+
+    public:
+        template <typename Scalar>
+        explicit QuantizedNetwork(BasicNeuralNetwork<Scalar> const &network);
+
+        size_t ninput() const {
+            return m_layers.front().size;
+        }
+
+        size_t noutput() const {
+            return m_layers.back().size;
+        }
+
+        // n'alloue pas, copie les activations de sortie dans outputs si non vide
+        template <typename Scalar>
+        size_t compute(util::Span<Scalar const> inputs, util::Span<float> outputs = {});
+
+        size_t output() const {
+            return m_output;
+        }
+
+        util::Span<float const> outputs() const {
+            return {m_current.data(), noutput()};
+        } // activations de sortie du dernier calcul
+    };
+
+    // Entrées rejouées par compareQuantized, ninput valeurs par échantillon.
+    // A remplir depuis le jeu, ex : record(inputs) juste avant network.compute(inputs).
+    template <typename Scalar>
+    class BasicInputRecord
+    {
+    private:
+        size_t m_ninput;
+        std::vector<Scalar> m_values;
+
+    public:
+        BasicInputRecord(size_t ninput) : m_ninput(ninput) {}
+
+        void record(util::Span<Scalar const> inputs) {
+            if (inputs.size() < m_ninput)
+                throw std::invalid_argument("InputRecord : pas assez d'entrees");
+            m_values.insert(m_values.end(), inputs.begin(), inputs.begin() + m_ninput);
+        }
+
+        size_t ninput() const {
+            return m_ninput;
+        }
+
+        size_t size() const {
+            return m_values.size() / m_ninput;
+        }
+
+        util::Span<Scalar const> operator[](size_t index) const {
+            return {m_values.data() + index * m_ninput, m_ninput};
+        }
+    };
+
+    struct QuantizationReport
+    {
+        size_t samples = 0;
+        size_t agree = 0;       // même argmax que la référence double
+        double max_error = 0;   // plus grand écart sur une sortie
+        double mean_error = 0;  // écart moyen sur les sorties
+
+        double agreement() const {
+            return samples == 0 ? 1 : (double)agree / samples;
+        }
+    };
+
+    // rejoue inputs sur network converti en double et sur quantized
+    template <typename Scalar>
+    QuantizationReport compareQuantized(BasicNeuralNetwork<Scalar> const &network, QuantizedNetwork &quantized, BasicInputRecord<Scalar> const &inputs);
+
+    using InputRecord = BasicInputRecord<double>;
+    using InputRecordf = BasicInputRecord<float>;
+
+    extern template QuantizedNetwork::QuantizedNetwork(BasicNeuralNetwork<float> const &);
+    extern template QuantizedNetwork::QuantizedNetwork(BasicNeuralNetwork<double> const &);
+    extern template size_t QuantizedNetwork::compute<float>(util::Span<float const>, util::Span<float>);
+    extern template size_t QuantizedNetwork::compute<double>(util::Span<double const>, util::Span<float>);
+    extern template QuantizationReport compareQuantized<float>(BasicNeuralNetwork<float> const &, QuantizedNetwork &, BasicInputRecord<float> const &);
+    extern template QuantizationReport compareQuantized<double>(BasicNeuralNetwork<double> const &, QuantizedNetwork &, BasicInputRecord<double> const &);
+
+} // namespace neuralnetwork
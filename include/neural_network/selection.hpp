@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "utils/random.hpp"
+#include "utils/span.hpp"
+
+namespace neuralnetwork
+{
+
+    // Méthode de choix des parents, la table est construite une fois par génération :
+    //  - Roulette   : probabilité proportionnelle à la fitness, sommes cumulées + recherche dichotomique, O(log n)
+    //  - Alias      : même loi que Roulette, table de Walker (méthode de Vose), O(1)
+    //  - Tournament : meilleur de tournament_size individus tirés uniformément, O(k), insensible à l'échelle
+    //  - Rank       : probabilité proportionnelle au rang (le pire a 1, le meilleur n), table d'alias, O(1)
+    // Une fitness négative compte pour 0, si toutes sont nulles le tirage est uniforme.
+    enum class selection_t : unsigned
+    {
+        Roulette,
+        Alias,
+        Tournament,
+        Rank
+    };
+
+    //
+    class Selection
+    {
+    private:
+        selection_t m_type;
+        size_t m_tournament_size;
+
+        size_t m_size;
+        bool m_uniform; // somme des fitness nulle
+        double m_total; // somme des fitness positives
+
+        std::vector<double> m_cumulative; // Roulette
+        std::vector<double> m_probability; // Alias, Rank
+        std::vector<uint32_t> m_alias;
+        std::vector<double> m_fitness; // Tournament
+
+        void buildAlias(util::Span<double const> weights, double total);
+
+    public:
+        Selection(selection_t type = selection_t::Roulette, size_t tournament_size = 3);
+
+        selection_t type() const {
+            return m_type;
+        }
+
+        void type(selection_t type) {
+            m_type = type;
+        }
+
+        size_t tournamentSize() const {
+            return m_tournament_size;
+        }
+
+        void tournamentSize(size_t size) {
+            m_tournament_size = size == 0 ? 1 : size;
+        }
+
+        void build(util::Span<double const> fitness); // à appeler après chaque évaluation, fitness[i] >= 0
+
+        size_t pick(util::Random &rng) const; // indice d'un parent, thread-safe après build
+
+        size_t size() const {
+            return m_size;
+        }
+
+        double total() const {
+            return m_total;
+        } // somme calculée par build, les fitness négatives comptent pour 0
+    };
+
+} // namespace neuralnetwork
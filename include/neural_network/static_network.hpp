@@ -0,0 +1,344 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "neural_network/genome_hash.hpp"
+#include "neural_network/mutation.hpp"
+#include "neural_network/neural_network.hpp"
+
+namespace neuralnetwork
+{
+
+    namespace detail
+    {
+        // tailles et décalages d'une topologie fixe, calculés à la compilation
+        template <size_t... Sizes>
+        struct StaticTopology
+        {
+            static constexpr size_t nlayers = sizeof...(Sizes);
+            static constexpr std::array<size_t, nlayers> sizes = {Sizes...};
+
+            static constexpr size_t paramOffset(size_t layer) {
+                size_t res = 0;
+                for (size_t l = 1; l < layer; l++)
+                    res += sizes[l] * sizes[l - 1] + sizes[l];
+                return res;
+            }
+
+            static constexpr size_t neuronOffset(size_t layer) {
+                size_t res = 0;
+                for (size_t l = 0; l < layer; l++)
+                    res += sizes[l];
+                return res;
+            }
+
+            // début des paramètres de chaque couche l >= 1, pour le croisement par couche
+            static constexpr std::array<size_t, nlayers - 1> paramBlocks() {
+                std::array<size_t, nlayers - 1> res{};
+                for (size_t l = 1; l < nlayers; l++)
+                    res[l - 1] = paramOffset(l);
+                return res;
+            }
+        };
+    } // namespace detail
+
+    // Réseau dont la topologie est fixée à la compilation, ex : BasicStaticNeuralNetwork<double, 8, 8, 4>.
+    // Les paramètres ont la même disposition que BasicNeuralNetwork (par couche : poids puis biais)
+    // mais sont stockés dans un std::array, et compute est déroulé couche par couche à la compilation.
+    // Si l'activation de sortie est strictement croissante (Identity, voir Activation::strictly_increasing),
+    // la dernière couche calcule l'argmax en même temps que les sorties et ne l'applique pas. Sinon, y compris
+    // avec Sigmoid par défaut, l'activation est appliquée puis l'argmax pris sur les sorties activées.
+    // Utilisable avec BasicPopulation et BasicGame, mais le type du réseau est un paramètre de template, pas une interface :
+    // un jeu écrit pour BasicGame<NeuralNetwork> doit hériter de BasicGame<BasicStaticNeuralNetwork<...>>
+    // et prendre ce type dans son operator().
+    template <typename Scalar, size_t... Sizes>
+    class BasicStaticNeuralNetwork
+    {
+        static_assert(sizeof...(Sizes) >= 2, "il faut au moins une couche d'entree et une de sortie");
+
+        using layout = detail::StaticTopology<Sizes...>;
+
+    public:
+        using scalar_type = Scalar;
+
+        static constexpr size_t nlayers = layout::nlayers;
+        static constexpr std::array<size_t, nlayers> sizes = layout::sizes;
+
+        static constexpr size_t nparams = layout::paramOffset(nlayers);
+        static constexpr size_t nneurons = layout::neuronOffset(nlayers - 1); // la sortie n'est pas stockée
+
+    private:
+        std::array<Scalar, nparams> m_params;
+        std::array<Scalar, nneurons> m_neurons;
+        std::array<activation_t, nlayers> m_activations;
+        std::array<Scalar, sizes.back()> m_last; // sortie avant activation
+
+        size_t m_output;
+
+        double m_score;
+        uint64_t m_hash;
+
+        template <size_t Layer>
+        void forward() {
+            constexpr size_t inputs = sizes[Layer - 1];
+            constexpr size_t outputs = sizes[Layer];
+
+            Scalar const *weights = m_params.data() + layout::paramOffset(Layer);
+            Scalar const *bias = weights + inputs * outputs;
+            Scalar const *in = m_neurons.data() + layout::neuronOffset(Layer - 1);
+
+            if constexpr (Layer + 1 < nlayers) {
+                Scalar *out = m_neurons.data() + layout::neuronOffset(Layer);
+
+                for (size_t i = 0; i < outputs; i++) {
+                    Scalar s = bias[i];
+                    for (size_t j = 0; j < inputs; j++)
+                        s += weights[i * inputs + j] * in[j];
+                    out[i] = s;
+                }
+
+                activate(m_activations[Layer], out, outputs);
+            } else {
+                // couche de sortie : m_last garde les valeurs avant activation
+                bool const fused = ActivationRegistry::singleton()[m_activations[Layer]].strictly_increasing;
+                Scalar max = 0;
+                m_output = 0;
+
+                for (size_t i = 0; i < outputs; i++) {
+                    Scalar s = bias[i];
+                    for (size_t j = 0; j < inputs; j++)
+                        s += weights[i * inputs + j] * in[j];
+
+                    m_last[i] = s;
+
+                    if (fused && (i == 0 || s > max)) {
+                        max = s;
+                        m_output = i;
+                    }
+                }
+
+                // sinon des sorties activées peuvent être égales : la première l'emporte, comme dans BasicNeuralNetwork
+                if (!fused) {
+                    std::array<Scalar, outputs> activated = m_last;
+                    activate(m_activations[Layer], activated.data(), outputs);
+                    m_output = std::max_element(activated.begin(), activated.end()) - activated.begin();
+                }
+            }
+        }
+
+        void init(NeuralParameters const &params, util::Random &rng) {
+            if (params.ninput != sizes.front() || params.noutput != sizes.back() ||
+                params.nhiddenlayer + 2 != nlayers)
+                throw std::invalid_argument("BasicStaticNeuralNetwork : parametres incompatibles avec la topologie");
+
+            for (size_t l = 1; l + 1 < nlayers; l++)
+                if (sizes[l] != params.nhidden)
+                    throw std::invalid_argument("BasicStaticNeuralNetwork : parametres incompatibles avec la topologie");
+
+            m_activations.fill(params.hidden_activation);
+            m_activations.front() = params.input_activation;
+            m_activations.back() = params.output_activation;
+
+            // même ordre de tirage que BasicNeuralNetwork
+            for (size_t l = 1; l < nlayers; l++) {
+                Scalar *weights = m_params.data() + layout::paramOffset(l);
+                Scalar *bias = weights + sizes[l] * sizes[l - 1];
+
+                rng.uniform(bias, sizes[l]);
+                for (size_t i = 0; i < sizes[l]; i++)
+                    bias[i] *= 2;
+
+                rng.uniform(weights, sizes[l] * sizes[l - 1]);
+                for (size_t i = 0; i < sizes[l] * sizes[l - 1]; i++)
+                    weights[i] *= 2;
+            }
+
+            rehash();
+        }
+
+        template <size_t... Layers>
+        void forwardAll(std::index_sequence<Layers...>) {
+            (forward<Layers + 1>(), ...);
+        }
+
+    public:
+        double m_fitness;
+
+        BasicStaticNeuralNetwork(NeuralParameters const &params) : m_neurons{}, m_output(0), m_score(-1), m_fitness(-1) {
+            util::Random rng(util::threadRandom()());
+            init(params, rng);
+        }
+
+        BasicStaticNeuralNetwork(NeuralParameters const &params, util::Random &rng) : m_neurons{}, m_output(0), m_score(-1), m_fitness(-1) {
+            init(params, rng);
+        }
+
+        // activations de shape, valeurs params, sans tirage
+        BasicStaticNeuralNetwork(BasicStaticNeuralNetwork const &shape, util::Span<Scalar const> params)
+            : m_neurons{}, m_activations(shape.m_activations), m_output(0), m_score(-1), m_fitness(-1) {
+            if (params.size() != nparams)
+                throw std::invalid_argument("BasicStaticNeuralNetwork : nombre de parametres different de la topologie");
+
+            std::copy(params.begin(), params.end(), m_params.begin());
+            rehash();
+        }
+
+        // conversion depuis un réseau dynamique de même topologie
+        explicit BasicStaticNeuralNetwork(BasicNeuralNetwork<Scalar> const &other)
+            : m_neurons{}, m_output(0), m_score(other.score()), m_fitness(other.fitness()) {
+            Topology const &topology = other.topology();
+
+            if (topology.sizes.size() != nlayers || !std::equal(sizes.begin(), sizes.end(), topology.sizes.begin()))
+                throw std::invalid_argument("BasicStaticNeuralNetwork : topologie differente");
+
+            std::copy(other.params().begin(), other.params().end(), m_params.begin());
+            std::copy(topology.activations.begin(), topology.activations.end(), m_activations.begin());
+
+            m_hash = other.hash();
+        }
+
+        size_t size() const {
+            return nlayers;
+        } // nombre de couches, entrée comprise
+
+        util::Span<Scalar> params() {
+            return {m_params.data(), nparams};
+        }
+
+        util::Span<Scalar const> params() const {
+            return {m_params.data(), nparams};
+        }
+
+        // même interface que BasicNeuralNetwork, aucune version n'alloue
+        size_t compute(std::vector<Scalar> const &inputs) {
+            return compute(util::Span<Scalar const>(inputs));
+        } //lance le calcul du nn
+
+        size_t compute(Scalar const *inputs, size_t n) {
+            return compute(util::Span<Scalar const>(inputs, n));
+        }
+
+        size_t compute(util::Span<Scalar const> inputs) {
+            if (inputs.size() < sizes.front())
+                throw std::invalid_argument("BasicStaticNeuralNetwork : pas assez d'entrees");
+
+            std::copy(inputs.begin(), inputs.begin() + sizes.front(), m_neurons.begin());
+            activate(m_activations.front(), m_neurons.data(), sizes.front());
+
+            forwardAll(std::make_index_sequence<nlayers - 1>());
+            return m_output;
+        }
+
+        size_t compute(util::Span<Scalar const> inputs, util::Span<Scalar> outputs) {
+            if (outputs.size() < sizes.back())
+                throw std::invalid_argument("BasicStaticNeuralNetwork : buffer de sortie trop petit");
+
+            size_t res = compute(inputs);
+
+            std::copy(m_last.begin(), m_last.end(), outputs.begin());
+            activate(m_activations.back(), outputs.data(), sizes.back());
+            return res;
+        }
+
+        size_t computeArgmax(util::Span<Scalar const> inputs) {
+            return compute(inputs);
+        } // l'argmax est toujours fusionné
+
+        size_t computeArgmax(Scalar const *inputs, size_t n) {
+            return compute(util::Span<Scalar const>(inputs, n));
+        }
+
+        size_t output() const {
+            return m_output;
+        } //va chercher le résultat du calcul
+
+        void score(double score) {
+            m_score = score;
+        } // set le score d'un nn
+
+        double score() const {
+            return m_score;
+        }
+
+        inline void fitness(double fitness) {
+            m_fitness = fitness;
+        } // set le fitness d'un nn
+
+        double fitness() const {
+            return m_fitness;
+        }
+
+        uint64_t hash() const {
+            return m_hash;
+        } // voir BasicNeuralNetwork::hash
+
+        void rehash() {
+            m_hash = hashing::genome<Scalar>(params());
+        }
+
+        void crossover(BasicStaticNeuralNetwork const &first, BasicStaticNeuralNetwork const &second, double const crossover_rate) {
+            size_t cut = (nparams * crossover_rate);
+
+            recombination::onePoint(params(), first.params(), second.params(), cut);
+            m_hash = hashing::splice(first.params(), first.m_hash, second.params(), second.m_hash, cut, nparams);
+        }
+
+        void crossover(BasicStaticNeuralNetwork const &first, BasicStaticNeuralNetwork const &second, crossover_t type,
+                       double const crossover_rate, util::Random &rng) {
+            static constexpr std::array<size_t, nlayers - 1> blocks = layout::paramBlocks();
+
+            size_t begin, end;
+
+            // même mise à jour de l'empreinte que BasicNeuralNetwork::crossover
+            switch (type) {
+                case crossover_t::OnePoint:
+                    crossover(first, second, crossover_rate);
+                    break;
+
+                case crossover_t::TwoPoint:
+                    recombination::twoPointRange(nparams, crossover_rate, rng, begin, end);
+                    recombination::twoPoint(params(), first.params(), second.params(), begin, end);
+                    m_hash = hashing::splice(first.params(), first.m_hash, second.params(), second.m_hash, begin, end);
+                    break;
+
+                default:
+                    recombination::apply(type, params(), first.params(), second.params(), crossover_rate,
+                                         util::Span<size_t const>(blocks.data(), blocks.size()), rng);
+
+                    if (&first == &second && type != crossover_t::Arithmetic)
+                        m_hash = first.m_hash;
+                    else
+                        rehash();
+                    break;
+            }
+        }
+
+        void mutate(double const mutation_rate) {
+            util::Random rng(util::threadRandom()());
+            mutate(mutation_rate, rng);
+        }
+
+        void mutate(double const mutation_rate, util::Random &rng, double const sigma = 0.05) {
+            // mêmes tirages que BasicNeuralNetwork::mutate
+            mutation::gaussian(params(), mutation_rate, sigma, rng, &m_hash);
+        }
+    };
+
+    template <typename Scalar, size_t... Sizes>
+    struct FixedTopology<BasicStaticNeuralNetwork<Scalar, Sizes...>>
+    {
+        static constexpr bool value = true;
+    };
+
+    template <size_t... Sizes>
+    using StaticNeuralNetwork = BasicStaticNeuralNetwork<double, Sizes...>;
+
+    template <size_t... Sizes>
+    using StaticNeuralNetworkf = BasicStaticNeuralNetwork<float, Sizes...>;
+
+} // namespace neuralnetwork
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace util {
+
+    /**
+     * @brief Cache de capacité fixe, l'élément le moins récemment utilisé est remplacé.
+     * Les noeuds sont dans un vecteur alloué une fois, la liste d'usage est chainée par indices.
+     * Pas thread-safe.
+     *
+     * @tparam Key
+     * @tparam Value
+     */
+    template <typename Key, typename Value>
+    class LruCache {
+        private :
+
+        static constexpr uint32_t none = UINT32_MAX;
+
+        struct Node {
+            Key key;
+            Value value;
+            uint32_t prev;
+            uint32_t next;
+        };
+
+        std::vector<Node> m_nodes;
+        std::unordered_map<Key, uint32_t> m_index;
+
+        size_t m_capacity;
+        uint32_t m_head; // plus récent
+        uint32_t m_tail; // plus ancien
+
+        void unlink(uint32_t node) {
+            Node &n = m_nodes[node];
+
+            if (n.prev != none) m_nodes[n.prev].next = n.next;
+            else m_head = n.next;
+
+            if (n.next != none) m_nodes[n.next].prev = n.prev;
+            else m_tail = n.prev;
+        }
+
+        void pushFront(uint32_t node) {
+            Node &n = m_nodes[node];
+            n.prev = none;
+            n.next = m_head;
+
+            if (m_head != none) m_nodes[m_head].prev = node;
+            m_head = node;
+
+            if (m_tail == none) m_tail = node;
+        }
+
+        public :
+
+        LruCache(size_t capacity = 0) : m_capacity(capacity), m_head(none), m_tail(none) {
+            m_nodes.reserve(capacity);
+            m_index.reserve(capacity);
+        }
+
+        /**
+         * @brief Cherche key, la marque comme récente si elle est présente
+         *
+         * @param key
+         * @param value
+         * @return true si key est dans le cache
+         */
+        bool find(Key const &key, Value &value) {
+            auto it = m_index.find(key);
+            if (it == m_index.end())
+                return false;
+
+            uint32_t node = it->second;
+            if (node != m_head) {
+                unlink(node);
+                pushFront(node);
+            }
+
+            value = m_nodes[node].value;
+            return true;
+        }
+
+        void insert(Key const &key, Value const &value) {
+            if (m_capacity == 0)
+                return;
+
+            auto it = m_index.find(key);
+            if (it != m_index.end()) {
+                m_nodes[it->second].value = value;
+                if (it->second != m_head) {
+                    unlink(it->second);
+                    pushFront(it->second);
+                }
+                return;
+            }
+
+            uint32_t node;
+
+            if (m_nodes.size() < m_capacity) {
+                node = m_nodes.size();
+                m_nodes.push_back({key, value, none, none});
+            } else {
+                // remplace le plus ancien
+                node = m_tail;
+                unlink(node);
+                m_index.erase(m_nodes[node].key);
+                m_nodes[node].key = key;
+                m_nodes[node].value = value;
+            }
+
+            m_index.emplace(key, node);
+            pushFront(node);
+        }
+
+        void clear() {
+            m_nodes.clear();
+            m_index.clear();
+            m_head = m_tail = none;
+        }
+
+        size_t size() const {
+            return m_nodes.size();
+        }
+
+        size_t capacity() const {
+            return m_capacity;
+        }
+    };
+
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+namespace util {
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "Mailbox : les atomiques 64 bits doivent etre sans verrou");
+
+    /**
+     * @brief Boite aux lettres sans verrou à un écrivain (seqlock), placée dans une mémoire fournie,
+     * éventuellement partagée entre processus. L'écrivain n'attend jamais ; un lecteur qui croise
+     * une écriture en cours échoue et réessaie plus tard. Seul le dernier message est gardé.
+     *
+     */
+    class Mailbox {
+        private :
+
+        struct Header {
+            std::atomic<uint64_t> sequence; // impair : écriture en cours
+            std::atomic<uint64_t> epoch;    // numéro du dernier message, 0 : vide
+            std::atomic<uint64_t> size;
+        };
+
+        Header *m_header;
+        unsigned char *m_data;
+        size_t m_capacity;
+
+        public :
+
+        /**
+         * @brief Octets occupés par une boite de capacity octets, multiple de 64
+         *
+         * @param capacity
+         * @return size_t
+         */
+        static constexpr size_t footprint(size_t capacity) {
+            return (sizeof(Header) + capacity + 63) / 64 * 64;
+        }
+
+        /**
+         * @brief memory : footprint(capacity) octets alignés sur 8, mis à zéro avant le premier usage
+         *
+         * @param memory
+         * @param capacity
+         */
+        Mailbox(void *memory, size_t capacity)
+            : m_header(static_cast<Header *>(memory)), m_data(static_cast<unsigned char *>(memory) + sizeof(Header)),
+              m_capacity(capacity) {}
+
+        size_t capacity() const {
+            return m_capacity;
+        }
+
+        uint64_t epoch() const {
+            return m_header->epoch.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief Remplace le message, un seul écrivain par boite. epoch > 0, size <= capacity
+         *
+         * @param data
+         * @param size
+         * @param epoch
+         */
+        void post(void const *data, size_t size, uint64_t epoch) {
+            uint64_t const sequence = m_header->sequence.load(std::memory_order_relaxed);
+
+            m_header->sequence.store(sequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            std::memcpy(m_data, data, size);
+            m_header->size.store(size, std::memory_order_relaxed);
+            m_header->epoch.store(epoch, std::memory_order_relaxed);
+
+            m_header->sequence.store(sequence + 2, std::memory_order_release);
+        }
+
+        /**
+         * @brief Copie le dernier message dans data. Faux si la boite est vide, si le message dépasse capacity
+         * ou si une écriture était en cours : data est alors à ignorer.
+         *
+         * @param data
+         * @param capacity
+         * @param epoch
+         * @param size
+         * @return true
+         * @return false
+         */
+        bool fetch(void *data, size_t capacity, uint64_t &epoch, size_t &size) const {
+            uint64_t const sequence = m_header->sequence.load(std::memory_order_acquire);
+            if (sequence & 1)
+                return false;
+
+            epoch = m_header->epoch.load(std::memory_order_relaxed);
+            size = m_header->size.load(std::memory_order_relaxed);
+            if (epoch == 0 || size > capacity)
+                return false;
+
+            std::memcpy(data, m_data, size);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return m_header->sequence.load(std::memory_order_relaxed) == sequence;
+        }
+    };
+
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace util {
+
+    /**
+     * @brief Fichier projeté en mémoire en lecture seule (mmap), le contenu est lu à la demande par le noyau.
+     *
+     */
+    class MappedFile {
+        private :
+
+        void *m_data;
+        size_t m_size;
+
+        MappedFile(void *data, size_t size) : m_data(data), m_size(size) {}
+
+        void release();
+
+        public :
+
+        MappedFile() : m_data(nullptr), m_size(0) {}
+
+        /**
+         * @brief Projette tout le fichier path
+         *
+         * @param path
+         * @return MappedFile
+         */
+        static MappedFile open(std::string const &path);
+
+        MappedFile(MappedFile const &) = delete;
+        MappedFile &operator=(MappedFile const &) = delete;
+
+        MappedFile(MappedFile &&other);
+        MappedFile &operator=(MappedFile &&other);
+
+        ~MappedFile();
+
+        /**
+         * @brief Annonce une lecture séquentielle de tout le fichier : le noyau lit en avance
+         *
+         */
+        void sequential() const;
+
+        void const *data() const {
+            return m_data;
+        }
+
+        size_t size() const {
+            return m_size;
+        }
+    };
+
+}
@@ -0,0 +1,330 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace util {
+
+    /**
+     * @brief Mélange 64 bits (finaliseur de SplitMix64), bijectif
+     *
+     * @param x
+     * @return uint64_t
+     */
+    inline uint64_t mix64(uint64_t x) {
+        x += 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    /**
+     * @brief xoshiro256++ : générateur séquentiel rapide, période 2^256 - 1.
+     * Adapté aux longues suites sur un seul thread, jump() sépare des sous-suites de 2^128 tirages.
+     *
+     */
+    class Xoshiro256pp {
+        private :
+
+        uint64_t m_state[4];
+
+        static uint64_t rotl(uint64_t x, int k) {
+            return (x << k) | (x >> (64 - k));
+        }
+
+        public :
+
+        explicit Xoshiro256pp(uint64_t seed = 0) {
+            // l'état est rempli par SplitMix64, jamais entièrement nul
+            for (int i = 0; i < 4; i++) {
+                m_state[i] = mix64(seed);
+                seed += 0x9E3779B97F4A7C15ull;
+            }
+        }
+
+        /**
+         * @brief Flux identifié par (seed, a, b), voir BasicRandom::stream
+         *
+         */
+        static Xoshiro256pp stream(uint64_t seed, uint64_t a, uint64_t b) {
+            return Xoshiro256pp(mix64(mix64(mix64(seed) ^ a) ^ b));
+        }
+
+        uint64_t operator()() {
+            uint64_t const result = rotl(m_state[0] + m_state[3], 23) + m_state[0];
+            uint64_t const t = m_state[1] << 17;
+
+            m_state[2] ^= m_state[0];
+            m_state[3] ^= m_state[1];
+            m_state[1] ^= m_state[2];
+            m_state[0] ^= m_state[3];
+
+            m_state[2] ^= t;
+            m_state[3] = rotl(m_state[3], 45);
+
+            return result;
+        }
+
+        /**
+         * @brief Avance de 2^128 tirages
+         *
+         */
+        void jump() {
+            static uint64_t const JUMP[] = {0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull};
+
+            uint64_t s[4] = {0, 0, 0, 0};
+            for (uint64_t jump : JUMP)
+                for (int b = 0; b < 64; b++) {
+                    if (jump & (1ull << b))
+                        for (int i = 0; i < 4; i++)
+                            s[i] ^= m_state[i];
+                    (*this)();
+                }
+
+            std::memcpy(m_state, s, sizeof(s));
+        }
+    };
+
+    /**
+     * @brief Philox4x32-10 : générateur à compteur, chaque bloc de 128 bits est une fonction pure de (clé, compteur).
+     * Le compteur est découpé en (bloc : 32 bits, a : 32 bits, b : 64 bits) : un flux (seed, a, b) est
+     * accessible directement sans dépendre des autres, et contient 2^32 blocs de 4 tirages 32 bits.
+     *
+     */
+    class Philox4x32 {
+        private :
+
+        uint32_t m_key[2];
+        uint32_t m_counter[4];
+
+        uint32_t m_buffer[4];
+        unsigned m_index; // prochain mot de m_buffer, 4 : bloc épuisé
+
+        void generate() {
+            static uint32_t const M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+            static uint32_t const W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+
+            uint32_t c[4] = {m_counter[0], m_counter[1], m_counter[2], m_counter[3]};
+            uint32_t k[2] = {m_key[0], m_key[1]};
+
+            for (int round = 0; round < 10; round++) {
+                uint64_t const p0 = (uint64_t)M0 * c[0];
+                uint64_t const p1 = (uint64_t)M1 * c[2];
+
+                uint32_t const n0 = (uint32_t)(p1 >> 32) ^ c[1] ^ k[0];
+                uint32_t const n2 = (uint32_t)(p0 >> 32) ^ c[3] ^ k[1];
+
+                c[0] = n0;
+                c[1] = (uint32_t)p1;
+                c[2] = n2;
+                c[3] = (uint32_t)p0;
+
+                k[0] += W0;
+                k[1] += W1;
+            }
+
+            std::memcpy(m_buffer, c, sizeof(c));
+            m_index = 0;
+            m_counter[0]++;
+        }
+
+        uint32_t next32() {
+            if (m_index == 4)
+                generate();
+            return m_buffer[m_index++];
+        }
+
+        public :
+
+        explicit Philox4x32(uint64_t seed = 0, uint32_t a = 0, uint64_t b = 0) : m_index(4) {
+            m_key[0] = (uint32_t)seed;
+            m_key[1] = (uint32_t)(seed >> 32);
+
+            m_counter[0] = 0;
+            m_counter[1] = a;
+            m_counter[2] = (uint32_t)b;
+            m_counter[3] = (uint32_t)(b >> 32);
+        }
+
+        /**
+         * @brief Flux identifié par (seed, a, b), a est tronqué à 32 bits
+         *
+         */
+        static Philox4x32 stream(uint64_t seed, uint64_t a, uint64_t b) {
+            return Philox4x32(seed, (uint32_t)a, b);
+        }
+
+        uint64_t operator()() {
+            uint64_t const low = next32();
+            return low | ((uint64_t)next32() << 32);
+        }
+    };
+
+    namespace detail {
+
+        // Box-Muller sur des blocs de 8 valeurs : u1 = values[0..4), u2 = values[4..8), uniformes dans ]0, 1].
+        // En sortie values[0..4) = r cos(2 pi u2), values[4..8) = r sin(2 pi u2). n multiple de 8.
+        // Version AVX2 + FMA (log et sincos polynomiaux, erreur relative < 1e-14) si le processeur le permet.
+        void boxMuller(double *values, size_t n);
+
+        /**
+         * @brief [0, 1[ sur 52 bits, sans conversion entière : la mantisse de 1.x moins 1
+         *
+         */
+        inline double toUniform(uint64_t bits) {
+            uint64_t const one = 0x3FF0000000000000ull | (bits >> 12);
+            double d;
+            std::memcpy(&d, &one, sizeof(d));
+            return d - 1.;
+        }
+
+        inline float toUniformf(uint64_t bits) {
+            uint32_t const one = 0x3F800000u | (uint32_t)(bits >> 41);
+            float f;
+            std::memcpy(&f, &one, sizeof(f));
+            return f - 1.f;
+        }
+
+    }
+
+    /**
+     * @brief Distributions au-dessus d'un générateur 64 bits : tirages unitaires et remplissage de tableaux.
+     * Les remplissages normaux passent par detail::boxMuller, vectorisé.
+     *
+     * @tparam Engine Xoshiro256pp, Philox4x32 ou tout générateur avec operator() 64 bits et stream(seed, a, b)
+     */
+    template <typename Engine>
+    class BasicRandom {
+        private :
+
+        Engine m_engine;
+
+        public :
+
+        using result_type = uint64_t;
+        using engine_type = Engine;
+
+        explicit BasicRandom(uint64_t seed = 0) : m_engine(seed) {}
+        explicit BasicRandom(Engine const &engine) : m_engine(engine) {}
+
+        /**
+         * @brief Flux identifié par (seed, a, b), ex : (graine du run, génération, indice)
+         *
+         * @param seed
+         * @param a
+         * @param b
+         * @return BasicRandom
+         */
+        static BasicRandom stream(uint64_t seed, uint64_t a, uint64_t b) {
+            return BasicRandom(Engine::stream(seed, a, b));
+        }
+
+        static constexpr uint64_t min() {
+            return 0;
+        }
+
+        static constexpr uint64_t max() {
+            return std::numeric_limits<uint64_t>::max();
+        }
+
+        uint64_t operator()() {
+            return m_engine();
+        }
+
+        Engine &engine() {
+            return m_engine;
+        }
+
+        /**
+         * @brief Tirage uniforme dans [0, 1[
+         *
+         * @return double
+         */
+        double uniform() {
+            return detail::toUniform(m_engine());
+        }
+
+        /**
+         * @brief Tirage uniforme dans ]0, 1]
+         *
+         * @return double
+         */
+        double uniformPositive() {
+            return 1. - uniform();
+        }
+
+        /**
+         * @brief Tirage selon une loi normale centrée réduite (Box-Muller)
+         *
+         * @return double
+         */
+        double normal() {
+            double v1 = uniformPositive();
+            double v2 = uniform();
+            return std::cos(2 * M_PI * v2) * std::sqrt(-2. * std::log(v1));
+        }
+
+        void uniform(double *values, size_t n) {
+            for (size_t i = 0; i < n; i++)
+                values[i] = detail::toUniform(m_engine());
+        }
+
+        void uniform(float *values, size_t n) {
+            for (size_t i = 0; i < n; i++)
+                values[i] = detail::toUniformf(m_engine());
+        }
+
+        /**
+         * @brief Remplit values de tirages selon N(mean, sigma²)
+         *
+         * @param values
+         * @param n
+         * @param mean
+         * @param sigma
+         */
+        void normal(double *values, size_t n, double mean = 0, double sigma = 1) {
+            size_t const full = n & ~size_t(7);
+
+            for (size_t i = 0; i < full; i++)
+                values[i] = 1. - detail::toUniform(m_engine());
+            detail::boxMuller(values, full);
+
+            if (full < n) {
+                double tail[8];
+                for (double &v : tail)
+                    v = 1. - detail::toUniform(m_engine());
+                detail::boxMuller(tail, 8);
+                std::memcpy(values + full, tail, (n - full) * sizeof(double));
+            }
+
+            if (mean != 0 || sigma != 1)
+                for (size_t i = 0; i < n; i++)
+                    values[i] = mean + sigma * values[i];
+        }
+
+        void normal(float *values, size_t n, float mean = 0, float sigma = 1) {
+            double block[64];
+
+            for (size_t i = 0; i < n; i += 64) {
+                size_t const count = n - i < 64 ? n - i : 64;
+                normal(block, count);
+
+                for (size_t j = 0; j < count; j++)
+                    values[i + j] = mean + sigma * (float)block[j];
+            }
+        }
+    };
+
+    using Random = BasicRandom<Philox4x32>;      // flux indépendants, utilisé par la reproduction
+    using FastRandom = BasicRandom<Xoshiro256pp>; // suite séquentielle
+
+    /**
+     * @brief Générateur propre au thread appelant, pour les tirages sans flux imposé (rand_gen, normalRandom, ...)
+     *
+     * @return FastRandom&
+     */
+    FastRandom &threadRandom();
+
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "utils/thread_pool.hpp"
+
+namespace util {
+
+    /**
+     * @brief Statistiques du dernier appel a WorkStealingScheduler::run
+     *
+     */
+    struct SchedulerStats {
+        size_t chunks = 0;        // nombre de blocs exécutés
+        size_t steals = 0;        // vols réussis
+        size_t failed_steals = 0; // tentatives de vol sur une file vide
+
+        double wall = 0;          // durée totale du run, en secondes
+        std::vector<double> busy; // temps passé a exécuter des blocs, par worker
+        std::vector<double> idle; // temps passé sans travail (recherche de vol, attente de fin), par worker
+
+        /**
+         * @brief Part du temps total des workers passée sans travail, 0 si parfaitement équilibré
+         *
+         * @return double
+         */
+        double idleRatio() const;
+    };
+
+    /**
+     * @brief Répartit les indices [0, n) en blocs, distribués au départ de façon contigue entre les workers.
+     * Chaque worker dépile ses blocs par la fin de sa file, un worker sans travail vole la moitié
+     * des blocs restants d'un autre worker par le début de sa file.
+     *
+     */
+    class WorkStealingScheduler {
+        private :
+
+        struct Range {
+            size_t begin;
+            size_t end;
+        };
+
+        struct alignas(64) Queue {
+            std::mutex mutex;
+            std::deque<Range> ranges;
+        };
+
+        std::vector<std::unique_ptr<Queue>> m_queues;
+
+        size_t m_chunk;
+        SchedulerStats m_stats;
+
+        bool pop(size_t worker, Range &range);
+        bool steal(size_t worker, size_t victim);
+
+        public :
+
+        /**
+         * @brief chunk : taille des blocs, 0 pour la choisir en fonction de n et du nombre de workers
+         *
+         * @param chunk
+         */
+        WorkStealingScheduler(size_t chunk = 0);
+
+        WorkStealingScheduler(WorkStealingScheduler const &) = delete;
+        WorkStealingScheduler &operator=(WorkStealingScheduler const &) = delete;
+
+        /**
+         * @brief Appelle task(worker, i) pour chaque i de [0, n) sur les workers de pool, et attend la fin
+         *
+         * @param pool
+         * @param n
+         * @param task
+         */
+        void run(ThreadPool &pool, size_t n, std::function<void(size_t, size_t)> const &task);
+
+        void chunk(size_t chunk) {
+            m_chunk = chunk;
+        }
+
+        size_t chunk() const {
+            return m_chunk;
+        }
+
+        SchedulerStats const &stats() const {
+            return m_stats;
+        }
+    };
+
+}
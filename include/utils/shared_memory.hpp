@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace util {
+
+    /**
+     * @brief Segment de mémoire partagé entre processus, initialisé à zéro.
+     * Anonyme : hérité par les processus créés avec fork. Nommé (shm_open) : visible par tout processus
+     * qui l'ouvre avec open, le nom est supprimé à la destruction du segment créé.
+     *
+     */
+    class SharedMemory {
+        private :
+
+        void *m_data;
+        size_t m_size;
+        std::string m_name;
+        bool m_owner; // supprime le nom à la destruction
+
+        SharedMemory(void *data, size_t size, std::string const &name, bool owner)
+            : m_data(data), m_size(size), m_name(name), m_owner(owner) {}
+
+        void release();
+
+        public :
+
+        SharedMemory() : m_data(nullptr), m_size(0), m_owner(false) {}
+
+        /**
+         * @brief Crée un segment de size octets, anonyme si name est vide (ex : "/vulkai-islands")
+         *
+         * @param size
+         * @param name
+         * @return SharedMemory
+         */
+        static SharedMemory create(size_t size, std::string const &name = "");
+
+        /**
+         * @brief Ouvre un segment nommé créé par un autre processus
+         *
+         * @param name
+         * @return SharedMemory
+         */
+        static SharedMemory open(std::string const &name);
+
+        SharedMemory(SharedMemory const &) = delete;
+        SharedMemory &operator=(SharedMemory const &) = delete;
+
+        SharedMemory(SharedMemory &&other);
+        SharedMemory &operator=(SharedMemory &&other);
+
+        ~SharedMemory();
+
+        void *data() const {
+            return m_data;
+        }
+
+        size_t size() const {
+            return m_size;
+        }
+
+        std::string const &name() const {
+            return m_name;
+        }
+    };
+
+}
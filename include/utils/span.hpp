@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace util {
+
+    /**
+     * @brief Vue non propriétaire sur une zone contigue (pointeur + taille)
+     *
+     * @tparam T
+     */
+    template <typename T>
+    class Span {
+        private :
+
+        T *m_data;
+        size_t m_size;
+
+        public :
+
+        Span() : m_data(nullptr), m_size(0) {}
+        Span(T *data, size_t size) : m_data(data), m_size(size) {}
+
+        template <typename U, typename = std::enable_if_t<std::is_same<std::remove_const_t<T>, U>::value>>
+        Span(std::vector<U> &vec) : m_data(vec.data()), m_size(vec.size()) {}
+
+        template <typename U, typename = std::enable_if_t<std::is_const<T>::value && std::is_same<std::remove_const_t<T>, U>::value>>
+        Span(std::vector<U> const &vec) : m_data(vec.data()), m_size(vec.size()) {}
+
+        operator Span<T const>() const {
+            return Span<T const>(m_data, m_size);
+        }
+
+        T *data() const {
+            return m_data;
+        }
+
+        size_t size() const {
+            return m_size;
+        }
+
+        bool empty() const {
+            return m_size == 0;
+        }
+
+        T &operator[](size_t index) const {
+            return m_data[index];
+        }
+
+        T *begin() const {
+            return m_data;
+        }
+
+        T *end() const {
+            return m_data + m_size;
+        }
+
+        Span subspan(size_t offset, size_t count) const {
+            return Span(m_data + offset, count);
+        }
+    };
+
+}
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace util {
+
+    /**
+     * @brief Min, max, moyenne et variance en une passe (Welford), fusionnables (Chan et al.)
+     *
+     */
+    class RunningStats {
+        private :
+
+        size_t m_count;
+        double m_mean;
+        double m_m2; // somme des carrés des écarts à la moyenne
+        double m_min;
+        double m_max;
+
+        public :
+
+        RunningStats();
+
+        void add(double value);
+        void merge(RunningStats const &other);
+        void clear();
+
+        size_t count() const {
+            return m_count;
+        }
+
+        double mean() const {
+            return m_mean;
+        }
+
+        double sum() const {
+            return m_mean * m_count;
+        }
+
+        double min() const {
+            return m_min;
+        }
+
+        double max() const {
+            return m_max;
+        }
+
+        /**
+         * @brief Variance de la population (divisée par n), 0 si vide
+         *
+         * @return double
+         */
+        double variance() const {
+            return m_count == 0 ? 0 : m_m2 / m_count;
+        }
+
+        double stddev() const;
+    };
+
+    /**
+     * @brief Quantiles approchés à erreur relative bornée (DDSketch) : la valeur renvoyée pour un quantile
+     * est à moins de accuracy * |valeur| de la valeur exacte. Les compteurs par intervalle logarithmique
+     * s'additionnent, la fusion ne dépend pas de l'ordre.
+     *
+     */
+    class QuantileSketch {
+        private :
+
+        // compteurs des clés [offset, offset + counts.size())
+        struct Store {
+            std::vector<uint64_t> counts;
+            int offset = 0;
+
+            void add(int key, uint64_t count);
+            void merge(Store const &other);
+        };
+
+        double m_accuracy;
+        double m_gamma;
+        double m_log_gamma;
+
+        Store m_positive;
+        Store m_negative; // clés de |valeur|
+        uint64_t m_zero;
+        uint64_t m_count;
+
+        int key(double value) const;
+        double value(int key) const;
+
+        public :
+
+        QuantileSketch(double accuracy = 0.01);
+
+        void add(double value);
+        void merge(QuantileSketch const &other); // même accuracy
+        void clear();
+
+        /**
+         * @brief Valeur du quantile q de [0, 1], 0 si vide
+         *
+         * @param q
+         * @return double
+         */
+        double quantile(double q) const;
+
+        uint64_t count() const {
+            return m_count;
+        }
+
+        double accuracy() const {
+            return m_accuracy;
+        }
+    };
+
+    /**
+     * @brief Les k plus grandes valeurs vues avec leur identifiant, à égalité le plus petit identifiant.
+     * Tableau trié de taille k : un ajout qui ne rentre pas coute O(1), sinon une recherche dichotomique et un décalage.
+     * Toujours trié, les accès const ne modifient rien et peuvent se faire depuis plusieurs threads.
+     *
+     */
+    class TopK {
+        public :
+
+        struct Entry {
+            double value;
+            uint64_t id;
+        };
+
+        private :
+
+        std::vector<Entry> m_entries; // de la meilleure à la moins bonne
+        size_t m_capacity;
+
+        public :
+
+        TopK(size_t capacity = 1) : m_capacity(capacity) {}
+
+        static bool better(Entry const &a, Entry const &b) {
+            return a.value > b.value || (a.value == b.value && a.id < b.id);
+        }
+
+        void add(double value, uint64_t id);
+        void merge(TopK const &other);
+
+        void clear() {
+            m_entries.clear();
+        }
+
+        void capacity(size_t capacity);
+
+        size_t capacity() const {
+            return m_capacity;
+        }
+
+        size_t size() const {
+            return m_entries.size();
+        }
+
+        bool empty() const {
+            return m_entries.empty();
+        }
+
+        /**
+         * @brief Entrées de la meilleure à la moins bonne
+         *
+         * @return std::vector<Entry> const&
+         */
+        std::vector<Entry> const &entries() const {
+            return m_entries;
+        }
+
+        Entry const &best() const {
+            return m_entries.front();
+        }
+    };
+
+    /**
+     * @brief Moments, quantiles et k meilleurs sur un flux de valeurs identifiées.
+     * Un objet par thread puis merge : rien n'est partagé pendant l'accumulation.
+     *
+     */
+    class Statistics {
+        private :
+
+        RunningStats m_moments;
+        QuantileSketch m_quantiles;
+        TopK m_top;
+
+        public :
+
+        Statistics(size_t top = 1, double accuracy = 0.01) : m_quantiles(accuracy), m_top(top) {}
+
+        void add(double value, uint64_t id) {
+            m_moments.add(value);
+            m_quantiles.add(value);
+            m_top.add(value, id);
+        }
+
+        void merge(Statistics const &other);
+        void clear();
+
+        RunningStats const &moments() const {
+            return m_moments;
+        }
+
+        QuantileSketch const &quantiles() const {
+            return m_quantiles;
+        }
+
+        TopK const &top() const {
+            return m_top;
+        }
+
+        TopK &top() {
+            return m_top;
+        }
+
+        size_t count() const {
+            return m_moments.count();
+        }
+
+        double min() const {
+            return m_moments.min();
+        }
+
+        double max() const {
+            return m_moments.max();
+        }
+
+        double mean() const {
+            return m_moments.mean();
+        }
+
+        double variance() const {
+            return m_moments.variance();
+        }
+
+        double quantile(double q) const {
+            return m_quantiles.quantile(q);
+        }
+    };
+
+}
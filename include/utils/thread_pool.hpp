@@ -0,0 +1,62 @@
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace util {
+
+    /**
+     * @brief Groupe de threads persistants. Chaque appel a run exécute une tache sur tous les workers
+     * et attend qu'ils aient tous terminé, les threads sont réutilisés d'un appel a l'autre.
+     *
+     */
+    class ThreadPool {
+        private :
+
+        std::vector<std::thread> m_workers;
+
+        std::mutex m_mutex;
+        std::condition_variable m_start;
+        std::condition_variable m_done;
+
+        std::function<void(size_t)> const *m_task;
+        std::exception_ptr m_error;
+
+        size_t m_generation; // incrémenté a chaque run, réveille les workers
+        size_t m_pending;    // workers n'ayant pas encore fini la tache courante
+        bool m_stop;
+
+        void work(size_t index);
+
+        public :
+
+        /**
+         * @brief Crée nthreads workers, un par coeur par défaut
+         *
+         * @param nthreads
+         */
+        ThreadPool(size_t nthreads = std::thread::hardware_concurrency());
+
+        ThreadPool(ThreadPool const &) = delete;
+        ThreadPool &operator=(ThreadPool const &) = delete;
+
+        ~ThreadPool();
+
+        /**
+         * @brief Exécute task(index du worker) sur chaque worker et attend la fin.
+         * La premiere exception levée par un worker est relancée ici.
+         *
+         * @param task
+         */
+        void run(std::function<void(size_t)> const &task);
+
+        size_t size() const {
+            return m_workers.size();
+        }
+    };
+
+}
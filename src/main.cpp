@@ -13,14 +13,12 @@ class testGame : public Game {
 private :
 
 
+    std::vector<double> tableau = std::vector<double>(12, 0.5); // réutilisé à chaque appel
+
 public :
     bool operator()(NeuralNetwork& val) {
 
-        std::vector<double> tableau;
-
-        tableau.resize(12, 0.5);
-
-        val.compute(tableau);
+        val.computeArgmax(tableau.data(), tableau.size());
 
         val.score(10);
 
@@ -39,12 +37,10 @@ int main() {
     Logger::singleton().config(config);
     Logger::log(StringLog("Message"));
 
-    std::srand(std::time(nullptr));
-
-    Layer test(10);
-
     NeuralParameters tmp;
 
+    tmp.seed = std::time(nullptr);
+
     tmp.nhidden = 8;
     tmp.noutput = 4;
     tmp.ninput = 8;
@@ -0,0 +1,391 @@
+#include "neural_network/activation.hpp"
+#include "neural_network/kernels.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define NEURAL_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+namespace neuralnetwork
+{
+
+    // au dela, la sigmoïde vaut 0 ou 1 à la précision double près
+    static constexpr double sigmoid_clamp = 40.;
+
+    static constexpr double log2e = 1.4426950408889634;
+    static constexpr double ln2_hi = 0.693145751953125;
+    static constexpr double ln2_lo = 1.42860682030941723212e-6;
+
+    static constexpr double lut_min = -16.;
+    static constexpr double lut_max = 16.;
+    static constexpr size_t lut_intervals = 4096;
+    static constexpr double lut_scale = lut_intervals / (lut_max - lut_min);
+
+    //////////////////////////////////////////////////////////////////////////////////////////////////
+    /////                                       Scalar                                           /////
+    //////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // exp(x) = 2^n * P(r), r = x - n * ln2, |r| <= ln2 / 2
+    template <typename Scalar>
+    static Scalar fastExp(Scalar x) {
+        Scalar n = std::nearbyint(x * Scalar(log2e));
+        Scalar r = x - n * Scalar(ln2_hi) - n * Scalar(ln2_lo);
+
+        Scalar p;
+        if (sizeof(Scalar) == sizeof(double))
+            p = 1 + r * (1 + r * (1. / 2 + r * (1. / 6 + r * (1. / 24 + r * (1. / 120 + r * (1. / 720 + r * (1. / 5040)))))));
+        else
+            p = 1 + r * (1 + r * (Scalar(1. / 2) + r * (Scalar(1. / 6) + r * (Scalar(1. / 24) + r * (Scalar(1. / 120) + r * Scalar(1. / 720))))));
+
+        return std::ldexp(p, static_cast<int>(n));
+    }
+
+    template <typename Scalar>
+    static Scalar sigmoid(Scalar x) {
+        return 1 / (1 + std::exp(-(x))); //default sigmoid
+    }
+
+    template <typename Scalar>
+    static Scalar fastSigmoid(Scalar x) {
+        x = std::min(std::max(x, Scalar(-sigmoid_clamp)), Scalar(sigmoid_clamp));
+        return 1 / (1 + fastExp(-x));
+    }
+
+    template <typename Scalar>
+    static Scalar rationalSigmoid(Scalar x) {
+        return Scalar(0.5) + Scalar(0.5) * x / (1 + std::fabs(x));
+    }
+
+    template <typename Scalar>
+    static std::vector<Scalar> const &sigmoidTable() {
+        static std::vector<Scalar> table = [] {
+            std::vector<Scalar> res(lut_intervals + 2);
+
+            for (size_t i = 0; i <= lut_intervals; i++)
+                res[i] = static_cast<Scalar>(sigmoid(lut_min + i / lut_scale));
+            res[lut_intervals + 1] = res[lut_intervals]; // x == lut_max : i + 1 reste dans la table
+
+            return res;
+        }();
+        return table;
+    }
+
+    template <typename Scalar>
+    static Scalar lutSigmoid(Scalar x) {
+        Scalar const *table = sigmoidTable<Scalar>().data();
+
+        Scalar t = (std::min(std::max(x, Scalar(lut_min)), Scalar(lut_max)) - Scalar(lut_min)) * Scalar(lut_scale);
+        size_t i = static_cast<size_t>(t);
+        Scalar f = t - i;
+
+        return table[i] + f * (table[i + 1] - table[i]);
+    }
+
+    template <typename Scalar>
+    static Scalar tanh(Scalar x) {
+        return std::tanh(x);
+    }
+
+    template <typename Scalar>
+    static Scalar relu(Scalar x) {
+        return x > 0 ? x : 0;
+    }
+
+    template <typename Scalar>
+    static Scalar identity(Scalar x) {
+        return x;
+    }
+
+    template <typename Scalar, Scalar (*function)(Scalar)>
+    static void applyScalar(Scalar *values, size_t n) {
+        for (size_t i = 0; i < n; i++)
+            values[i] = function(values[i]);
+    }
+
+    template <typename Scalar>
+    static void applyIdentity(Scalar *, size_t) {}
+
+#ifdef NEURAL_KERNELS_X86
+
+    //////////////////////////////////////////////////////////////////////////////////////////////////
+    /////                                        AVX2                                            /////
+    //////////////////////////////////////////////////////////////////////////////////////////////////
+
+    __attribute__((target("avx2,fma")))
+    static __m256d fastExpAVX2(__m256d x) {
+        __m256d n = _mm256_round_pd(_mm256_mul_pd(x, _mm256_set1_pd(log2e)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        __m256d r = _mm256_fnmadd_pd(n, _mm256_set1_pd(ln2_hi), x);
+        r = _mm256_fnmadd_pd(n, _mm256_set1_pd(ln2_lo), r);
+
+        __m256d p = _mm256_set1_pd(1. / 5040);
+        p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1. / 720));
+        p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1. / 120));
+        p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1. / 24));
+        p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1. / 6));
+        p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1. / 2));
+        p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.));
+        p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.));
+
+        // 2^n construit directement dans l'exposant
+        __m256i e = _mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(n));
+        e = _mm256_slli_epi64(_mm256_add_epi64(e, _mm256_set1_epi64x(1023)), 52);
+
+        return _mm256_mul_pd(p, _mm256_castsi256_pd(e));
+    }
+
+    __attribute__((target("avx2,fma")))
+    static __m256 fastExpAVX2(__m256 x) {
+        __m256 n = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(float(log2e))), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        __m256 r = _mm256_fnmadd_ps(n, _mm256_set1_ps(float(ln2_hi)), x);
+        r = _mm256_fnmadd_ps(n, _mm256_set1_ps(float(ln2_lo)), r);
+
+        __m256 p = _mm256_set1_ps(1.f / 720);
+        p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(1.f / 120));
+        p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(1.f / 24));
+        p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(1.f / 6));
+        p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(1.f / 2));
+        p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(1.f));
+        p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(1.f));
+
+        __m256i e = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127)), 23);
+
+        return _mm256_mul_ps(p, _mm256_castsi256_ps(e));
+    }
+
+    __attribute__((target("avx2,fma")))
+    static void fastSigmoidAVX2(double *values, size_t n) {
+        __m256d const low = _mm256_set1_pd(-sigmoid_clamp);
+        __m256d const high = _mm256_set1_pd(sigmoid_clamp);
+        __m256d const one = _mm256_set1_pd(1.);
+        size_t i = 0;
+
+        for (; i + 4 <= n; i += 4) {
+            __m256d x = _mm256_min_pd(_mm256_max_pd(_mm256_loadu_pd(values + i), low), high);
+            __m256d e = fastExpAVX2(_mm256_sub_pd(_mm256_setzero_pd(), x));
+            _mm256_storeu_pd(values + i, _mm256_div_pd(one, _mm256_add_pd(one, e)));
+        }
+
+        for (; i < n; i++)
+            values[i] = fastSigmoid(values[i]);
+    }
+
+    __attribute__((target("avx2,fma")))
+    static void fastSigmoidAVX2(float *values, size_t n) {
+        __m256 const low = _mm256_set1_ps(float(-sigmoid_clamp));
+        __m256 const high = _mm256_set1_ps(float(sigmoid_clamp));
+        __m256 const one = _mm256_set1_ps(1.f);
+        size_t i = 0;
+
+        for (; i + 8 <= n; i += 8) {
+            __m256 x = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(values + i), low), high);
+            __m256 e = fastExpAVX2(_mm256_sub_ps(_mm256_setzero_ps(), x));
+            _mm256_storeu_ps(values + i, _mm256_div_ps(one, _mm256_add_ps(one, e)));
+        }
+
+        for (; i < n; i++)
+            values[i] = fastSigmoid(values[i]);
+    }
+
+    __attribute__((target("avx2,fma")))
+    static void rationalSigmoidAVX2(double *values, size_t n) {
+        __m256d const half = _mm256_set1_pd(0.5);
+        __m256d const one = _mm256_set1_pd(1.);
+        __m256d const sign = _mm256_set1_pd(-0.);
+        size_t i = 0;
+
+        for (; i + 4 <= n; i += 4) {
+            __m256d x = _mm256_loadu_pd(values + i);
+            __m256d d = _mm256_add_pd(one, _mm256_andnot_pd(sign, x));
+            _mm256_storeu_pd(values + i, _mm256_fmadd_pd(half, _mm256_div_pd(x, d), half));
+        }
+
+        for (; i < n; i++)
+            values[i] = rationalSigmoid(values[i]);
+    }
+
+    __attribute__((target("avx2,fma")))
+    static void rationalSigmoidAVX2(float *values, size_t n) {
+        __m256 const half = _mm256_set1_ps(0.5f);
+        __m256 const one = _mm256_set1_ps(1.f);
+        __m256 const sign = _mm256_set1_ps(-0.f);
+        size_t i = 0;
+
+        for (; i + 8 <= n; i += 8) {
+            __m256 x = _mm256_loadu_ps(values + i);
+            __m256 d = _mm256_add_ps(one, _mm256_andnot_ps(sign, x));
+            _mm256_storeu_ps(values + i, _mm256_fmadd_ps(half, _mm256_div_ps(x, d), half));
+        }
+
+        for (; i < n; i++)
+            values[i] = rationalSigmoid(values[i]);
+    }
+
+    __attribute__((target("avx2,fma")))
+    static void lutSigmoidAVX2(double *values, size_t n) {
+        double const *table = sigmoidTable<double>().data();
+
+        __m256d const low = _mm256_set1_pd(lut_min);
+        __m256d const high = _mm256_set1_pd(lut_max);
+        __m256d const scale = _mm256_set1_pd(lut_scale);
+        __m256d const all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+        size_t i = 0;
+
+        for (; i + 4 <= n; i += 4) {
+            __m256d x = _mm256_min_pd(_mm256_max_pd(_mm256_loadu_pd(values + i), low), high);
+            __m256d t = _mm256_mul_pd(_mm256_sub_pd(x, low), scale);
+
+            __m128i index = _mm256_cvttpd_epi32(t);
+            __m256d f = _mm256_sub_pd(t, _mm256_cvtepi32_pd(index));
+
+            // gather masqué sur une source nulle : _mm256_i32gather_pd part d'une valeur indéfinie (-Wmaybe-uninitialized avec GCC)
+            __m256d a = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), table, index, all, 8);
+            __m256d b = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), table + 1, index, all, 8);
+
+            _mm256_storeu_pd(values + i, _mm256_fmadd_pd(f, _mm256_sub_pd(b, a), a));
+        }
+
+        for (; i < n; i++)
+            values[i] = lutSigmoid(values[i]);
+    }
+
+    __attribute__((target("avx2,fma")))
+    static void lutSigmoidAVX2(float *values, size_t n) {
+        float const *table = sigmoidTable<float>().data();
+
+        __m256 const low = _mm256_set1_ps(float(lut_min));
+        __m256 const high = _mm256_set1_ps(float(lut_max));
+        __m256 const scale = _mm256_set1_ps(float(lut_scale));
+        size_t i = 0;
+
+        for (; i + 8 <= n; i += 8) {
+            __m256 x = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(values + i), low), high);
+            __m256 t = _mm256_mul_ps(_mm256_sub_ps(x, low), scale);
+
+            __m256i index = _mm256_cvttps_epi32(t);
+            __m256 f = _mm256_sub_ps(t, _mm256_cvtepi32_ps(index));
+
+            __m256 a = _mm256_i32gather_ps(table, index, 4);
+            __m256 b = _mm256_i32gather_ps(table + 1, index, 4);
+
+            _mm256_storeu_ps(values + i, _mm256_fmadd_ps(f, _mm256_sub_ps(b, a), a));
+        }
+
+        for (; i < n; i++)
+            values[i] = lutSigmoid(values[i]);
+    }
+
+    __attribute__((target("avx2,fma")))
+    static void reluAVX2(double *values, size_t n) {
+        size_t i = 0;
+
+        for (; i + 4 <= n; i += 4)
+            _mm256_storeu_pd(values + i, _mm256_max_pd(_mm256_loadu_pd(values + i), _mm256_setzero_pd()));
+
+        for (; i < n; i++)
+            values[i] = relu(values[i]);
+    }
+
+    __attribute__((target("avx2,fma")))
+    static void reluAVX2(float *values, size_t n) {
+        size_t i = 0;
+
+        for (; i + 8 <= n; i += 8)
+            _mm256_storeu_ps(values + i, _mm256_max_ps(_mm256_loadu_ps(values + i), _mm256_setzero_ps()));
+
+        for (; i < n; i++)
+            values[i] = relu(values[i]);
+    }
+
+#endif
+
+    //////////////////////////////////////////////////////////////////////////////////////////////////
+    /////                                      Dispatch                                          /////
+    //////////////////////////////////////////////////////////////////////////////////////////////////
+
+    static bool useAVX2() {
+        return kernels::isa() >= kernels::isa_t::AVX2;
+    }
+
+#ifdef NEURAL_KERNELS_X86
+#define NEURAL_ACTIVATION_DISPATCH(name)                          \
+    template <typename Scalar>                                    \
+    static void name##Apply(Scalar *values, size_t n) {           \
+        if (useAVX2())                                            \
+            name##AVX2(values, n);                                \
+        else                                                      \
+            applyScalar<Scalar, name<Scalar>>(values, n);         \
+    }
+#else
+#define NEURAL_ACTIVATION_DISPATCH(name)                          \
+    template <typename Scalar>                                    \
+    static void name##Apply(Scalar *values, size_t n) {           \
+        applyScalar<Scalar, name<Scalar>>(values, n);             \
+    }
+#endif
+
+    NEURAL_ACTIVATION_DISPATCH(fastSigmoid)
+    NEURAL_ACTIVATION_DISPATCH(rationalSigmoid)
+    NEURAL_ACTIVATION_DISPATCH(lutSigmoid)
+    NEURAL_ACTIVATION_DISPATCH(relu)
+
+#undef NEURAL_ACTIVATION_DISPATCH
+
+    //////////////////////////////////////////////////////////////////////////////////////////////////
+    /////                                 ActivationRegistry                                     /////
+    //////////////////////////////////////////////////////////////////////////////////////////////////
+
+    ActivationRegistry::ActivationRegistry() {
+        // même ordre que activation_t
+        m_activations.push_back({"sigmoid", 0., false,
+                                 {sigmoid<float>, applyScalar<float, sigmoid<float>>},
+                                 {sigmoid<double>, applyScalar<double, sigmoid<double>>}});
+
+        m_activations.push_back({"fast_sigmoid", 2e-9, false,
+                                 {fastSigmoid<float>, fastSigmoidApply<float>},
+                                 {fastSigmoid<double>, fastSigmoidApply<double>}});
+
+        m_activations.push_back({"rational_sigmoid", 0.083, false,
+                                 {rationalSigmoid<float>, rationalSigmoidApply<float>},
+                                 {rationalSigmoid<double>, rationalSigmoidApply<double>}});
+
+        m_activations.push_back({"sigmoid_lut", 8e-7, false,
+                                 {lutSigmoid<float>, lutSigmoidApply<float>},
+                                 {lutSigmoid<double>, lutSigmoidApply<double>}});
+
+        m_activations.push_back({"tanh", 0., false,
+                                 {tanh<float>, applyScalar<float, tanh<float>>},
+                                 {tanh<double>, applyScalar<double, tanh<double>>}});
+
+        m_activations.push_back({"relu", 0., false,
+                                 {relu<float>, reluApply<float>},
+                                 {relu<double>, reluApply<double>}});
+
+        m_activations.push_back({"identity", 0., true,
+                                 {identity<float>, applyIdentity<float>},
+                                 {identity<double>, applyIdentity<double>}});
+    }
+
+    ActivationRegistry &ActivationRegistry::singleton() {
+        static ActivationRegistry registry;
+        return registry;
+    }
+
+    activation_t ActivationRegistry::add(Activation const &activation) {
+        m_activations.push_back(activation);
+        return static_cast<activation_t>(m_activations.size() - 1);
+    }
+
+    bool ActivationRegistry::find(std::string const &name, activation_t &id) const {
+        for (size_t i = 0; i < m_activations.size(); i++) {
+            if (m_activations[i].name == name) {
+                id = static_cast<activation_t>(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+} // namespace neuralnetwork
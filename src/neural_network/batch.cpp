@@ -0,0 +1,135 @@
+#include "neural_network/neural_network.hpp"
+#include "neural_network/kernels.hpp"
+
+#include <stdexcept>
+
+namespace neuralnetwork
+{
+
+    //////////////////////////////////////////////////////////////////////////////////////////////////
+    /////                                     BatchNetwork                                       /////
+    //////////////////////////////////////////////////////////////////////////////////////////////////
+
+    template <typename Scalar>
+    BasicBatchNetwork<Scalar>::BasicBatchNetwork() : m_count(0) {}
+
+    template <typename Scalar>
+    BasicBatchNetwork<Scalar>::BasicBatchNetwork(std::vector<BasicNeuralNetwork<Scalar>> const &networks) : m_count(0) {
+        load(networks);
+    }
+
+    template <typename Scalar>
+    void BasicBatchNetwork<Scalar>::load(std::vector<BasicNeuralNetwork<Scalar>> const &networks) {
+        std::vector<BasicNeuralNetwork<Scalar> const *> pointers(networks.size());
+
+        for (size_t g = 0; g < networks.size(); g++)
+            pointers[g] = &networks[g];
+
+        load(pointers);
+    }
+
+    template <typename Scalar>
+    void BasicBatchNetwork<Scalar>::load(util::Span<BasicNeuralNetwork<Scalar> const *const> networks) {
+        m_count = networks.size();
+
+        if (m_count == 0)
+            return;
+
+        m_topology = networks[0]->sharedTopology();
+
+        Topology const &topology = *m_topology;
+
+        m_params.resize(topology.nparams * m_count);
+        m_neurons.resize(topology.nneurons * m_count);
+
+        // entrelacement : le paramètre p du génome g va en p * count + g
+        for (size_t g = 0; g < m_count; g++) {
+            BasicNeuralNetwork<Scalar> const &nn = *networks[g];
+
+            if (nn.sharedTopology() != m_topology && nn.topology() != topology)
+                throw std::invalid_argument("BatchNetwork : topologies differentes");
+
+            auto params = nn.params();
+
+            for (size_t p = 0; p < params.size(); p++)
+                m_params[p * m_count + g] = params[p];
+        }
+    }
+
+    template <typename Scalar>
+    void BasicBatchNetwork<Scalar>::compute(Scalar const *inputs, size_t *outputs) {
+        if (m_count == 0)
+            return;
+
+        Topology const &topology = *m_topology;
+
+        size_t const n = m_count;
+        size_t const ninputs = topology.sizes.front();
+
+        // transposition des entrées : une ligne par génome -> un neurone par ligne
+        Scalar *first = &m_neurons[0];
+
+        for (size_t g = 0; g < n; g++)
+            for (size_t i = 0; i < ninputs; i++)
+                first[i * n + g] = inputs[g * ninputs + i];
+
+        activate(topology.activations[0], first, ninputs * n);
+
+        for (size_t l = 1; l < topology.sizes.size(); l++) {
+            size_t const previous = topology.sizes[l - 1];
+            size_t const current = topology.sizes[l];
+
+            Scalar const *in = &m_neurons[topology.neuron_offsets[l - 1] * n];
+            Scalar *out = &m_neurons[topology.neuron_offsets[l] * n];
+
+            Scalar const *weights = &m_params[topology.param_offsets[l] * n];
+            Scalar const *bias = weights + previous * current * n;
+
+            for (size_t i = 0; i < current; i++) {
+                Scalar *row = out + i * n;
+
+                for (size_t g = 0; g < n; g++)
+                    row[g] = bias[i * n + g];
+
+                for (size_t j = 0; j < previous; j++)
+                    kernels::multiplyAdd(row, weights + (i * previous + j) * n, in + j * n, n);
+            }
+
+            // toute la couche est contiguë, une seule passe d'activation
+            activate(topology.activations[l], out, current * n);
+        }
+
+        // argmax de chaque génome, même règle que NeuralNetwork::output
+        Scalar const *last = &m_neurons[topology.neuron_offsets.back() * n];
+        size_t const noutputs = topology.sizes.back();
+
+        for (size_t g = 0; g < n; g++)
+            outputs[g] = 0;
+
+        for (size_t i = 1; i < noutputs; i++)
+            for (size_t g = 0; g < n; g++)
+                if (last[i * n + g] > last[outputs[g] * n + g])
+                    outputs[g] = i;
+    }
+
+    template <typename Scalar>
+    void BasicBatchNetwork<Scalar>::compute(std::vector<Scalar> const &inputs, std::vector<size_t> &outputs) {
+        if (inputs.size() < m_count * ninput())
+            throw std::invalid_argument("BatchNetwork : pas assez d'entrees");
+
+        outputs.resize(m_count);
+        compute(inputs.data(), outputs.data());
+    }
+
+    template <typename Scalar>
+    void BasicBatchNetwork<Scalar>::compute(util::Span<Scalar const> inputs, util::Span<size_t> outputs) {
+        if (inputs.size() < m_count * ninput() || outputs.size() < m_count)
+            throw std::invalid_argument("BatchNetwork : buffers trop petits");
+
+        compute(inputs.data(), outputs.data());
+    }
+
+    template class BasicBatchNetwork<float>;
+    template class BasicBatchNetwork<double>;
+
+} // namespace neuralnetwork
@@ -0,0 +1,241 @@
+#include "neural_network/checkpoint.hpp"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace neuralnetwork
+{
+
+    namespace checkpoint
+    {
+        static uint64_t alignUp(uint64_t value, uint64_t alignment) {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+        static uint64_t checksum(Header const &header) {
+            uint64_t words[offsetof(Header, checksum) / sizeof(uint64_t)];
+            std::memcpy(words, &header, sizeof(words));
+
+            uint64_t h = VERSION;
+            for (uint64_t w : words)
+                h = util::mix64(h ^ w);
+            return h;
+        }
+
+        static_assert(offsetof(Header, checksum) % sizeof(uint64_t) == 0, "checkpoint::Header : empreinte non alignée");
+
+        Parameters::Parameters(NeuralParameters const &params) {
+            std::memset(this, 0, sizeof(*this));
+
+            crossover_rate = params.crossover_rate;
+            mutation_rate = params.mutation_rate;
+            mutation_sigma = params.mutation_sigma;
+            add_node_rate = params.add_node_rate;
+            add_connection_rate = params.add_connection_rate;
+            compatibility_disjoint = params.compatibility_disjoint;
+            compatibility_weight = params.compatibility_weight;
+            compatibility_threshold = params.compatibility_threshold;
+            fitness_cache = params.fitness_cache;
+            seed = params.seed;
+            nhiddenlayer = params.nhiddenlayer;
+            ninput = params.ninput;
+            nhidden = params.nhidden;
+            noutput = params.noutput;
+            elitism = params.elitism;
+            top_k = params.top_k;
+            crossover = static_cast<uint32_t>(params.crossover);
+            selection = static_cast<uint32_t>(params.selection);
+            tournament_size = params.tournament_size;
+            input_activation = static_cast<uint32_t>(params.input_activation);
+            hidden_activation = static_cast<uint32_t>(params.hidden_activation);
+            output_activation = static_cast<uint32_t>(params.output_activation);
+        }
+
+        NeuralParameters Parameters::decode() const {
+            NeuralParameters params{};
+
+            params.crossover_rate = crossover_rate;
+            params.mutation_rate = mutation_rate;
+            params.mutation_sigma = mutation_sigma;
+            params.add_node_rate = add_node_rate;
+            params.add_connection_rate = add_connection_rate;
+            params.compatibility_disjoint = compatibility_disjoint;
+            params.compatibility_weight = compatibility_weight;
+            params.compatibility_threshold = compatibility_threshold;
+            params.fitness_cache = fitness_cache;
+            params.seed = seed;
+            params.nhiddenlayer = nhiddenlayer;
+            params.ninput = ninput;
+            params.nhidden = nhidden;
+            params.noutput = noutput;
+            params.elitism = elitism;
+            params.top_k = top_k;
+            params.crossover = static_cast<crossover_t>(crossover);
+            params.selection = static_cast<selection_t>(selection);
+            params.tournament_size = tournament_size;
+            params.input_activation = static_cast<activation_t>(input_activation);
+            params.hidden_activation = static_cast<activation_t>(hidden_activation);
+            params.output_activation = static_cast<activation_t>(output_activation);
+            return params;
+        }
+
+        Header header(NeuralParameters const &params, uint64_t population, uint64_t nparams, uint32_t scalar_size, uint64_t generation) {
+            Header header;
+            std::memset(&header, 0, sizeof(header));
+
+            std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+            header.version = VERSION;
+            header.endian = ENDIAN;
+            header.header_size = sizeof(Header);
+            header.scalar_size = scalar_size;
+
+            header.population = population;
+            header.nparams = nparams;
+            header.stride = alignUp(nparams * scalar_size, ALIGN);
+            header.params_offset = alignUp(sizeof(Header), PAGE);
+            header.scores_offset = alignUp(header.params_offset + population * header.stride, PAGE);
+            header.file_size = alignUp(header.scores_offset + population * sizeof(double), PAGE);
+
+            header.generation = generation;
+            header.params = Parameters(params);
+
+            header.checksum = checksum(header);
+            return header;
+        }
+
+        void validate(Header const &header, size_t size) {
+            if (size < sizeof(Header) || std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+                throw std::runtime_error("checkpoint : fichier non reconnu");
+            if (header.endian != ENDIAN)
+                throw std::runtime_error("checkpoint : ordre des octets different de celui de la machine");
+            if (header.version != VERSION || header.header_size != sizeof(Header))
+                throw std::runtime_error("checkpoint : version " + std::to_string(header.version) + " non supportee");
+            if (header.checksum != checksum(header))
+                throw std::runtime_error("checkpoint : en-tete corrompu");
+
+            if (header.scalar_size != sizeof(float) && header.scalar_size != sizeof(double))
+                throw std::runtime_error("checkpoint : type scalaire inconnu");
+            if (header.stride < header.nparams * header.scalar_size || header.stride % ALIGN != 0 || header.params_offset % PAGE != 0 ||
+                header.scores_offset < header.params_offset + header.population * header.stride || header.scores_offset % PAGE != 0 ||
+                header.file_size < header.scores_offset + header.population * sizeof(double))
+                throw std::runtime_error("checkpoint : offsets incoherents");
+            if (header.file_size > size)
+                throw std::runtime_error("checkpoint : fichier tronque");
+        }
+
+        Writer::Writer(std::string const &path, size_t buffer) : m_path(path), m_buffer(buffer), m_used(0), m_offset(0) {
+            m_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (m_fd < 0)
+                throw std::runtime_error("checkpoint : open " + path + " : " + std::strerror(errno));
+        }
+
+        Writer::~Writer() {
+            if (m_fd >= 0)
+                ::close(m_fd);
+        }
+
+        void Writer::flush() {
+            char const *data = m_buffer.data();
+            size_t remaining = m_used;
+
+            while (remaining > 0) {
+                ssize_t written = ::write(m_fd, data, remaining);
+                if (written < 0) {
+                    if (errno == EINTR)
+                        continue;
+                    throw std::runtime_error("checkpoint : write " + m_path + " : " + std::strerror(errno));
+                }
+                data += written;
+                remaining -= written;
+            }
+            m_used = 0;
+        }
+
+        void Writer::write(void const *data, size_t size) {
+            char const *bytes = static_cast<char const *>(data);
+            m_offset += size;
+
+            while (size > 0) {
+                if (m_used == m_buffer.size())
+                    flush();
+
+                size_t count = std::min(size, m_buffer.size() - m_used);
+                std::memcpy(m_buffer.data() + m_used, bytes, count);
+
+                m_used += count;
+                bytes += count;
+                size -= count;
+            }
+        }
+
+        void Writer::pad(uint64_t offset) {
+            while (m_offset < offset) {
+                if (m_used == m_buffer.size())
+                    flush();
+
+                size_t count = std::min<uint64_t>(offset - m_offset, m_buffer.size() - m_used);
+                std::memset(m_buffer.data() + m_used, 0, count);
+
+                m_used += count;
+                m_offset += count;
+            }
+        }
+
+        void Writer::sync() {
+            flush();
+
+            if (fsync(m_fd) != 0)
+                throw std::runtime_error("checkpoint : fsync " + m_path + " : " + std::strerror(errno));
+        }
+
+        void Writer::close() {
+            flush();
+
+            int fd = m_fd;
+            m_fd = -1;
+            if (::close(fd) != 0)
+                throw std::runtime_error("checkpoint : close " + m_path + " : " + std::strerror(errno));
+        }
+
+        std::string path(std::string const &directory, std::string const &prefix, uint64_t generation, char const *extension) {
+            char number[24];
+            std::snprintf(number, sizeof(number), "%08llu", (unsigned long long)generation);
+            return directory + "/" + prefix + "-" + number + "." + extension;
+        }
+
+        void write(Header const &header, std::vector<void const *> const &genomes, util::Span<double const> scores, std::string const &path,
+                   bool sync) {
+            if (genomes.size() != header.population || scores.size() != header.population)
+                throw std::invalid_argument("checkpoint : nombre de genomes different de l'en-tete");
+
+            Writer writer(path);
+
+            writer.write(&header, sizeof(header));
+            writer.pad(header.params_offset);
+
+            for (size_t i = 0; i < genomes.size(); i++) {
+                writer.write(genomes[i], header.nparams * header.scalar_size);
+                writer.pad(header.params_offset + (i + 1) * header.stride);
+            }
+
+            writer.pad(header.scores_offset);
+            writer.write(scores.data(), scores.size() * sizeof(double));
+            writer.pad(header.file_size);
+
+            if (sync)
+                writer.sync();
+            writer.close();
+        }
+    } // namespace checkpoint
+
+    MappedCheckpoint::MappedCheckpoint(std::string const &path) : m_file(util::MappedFile::open(path)) {
+        m_header = static_cast<checkpoint::Header const *>(m_file.data());
+        checkpoint::validate(*m_header, m_file.size());
+    }
+
+} // namespace neuralnetwork
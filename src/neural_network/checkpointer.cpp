@@ -0,0 +1,184 @@
+#include "neural_network/checkpointer.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace neuralnetwork
+{
+
+    static std::runtime_error systemError(std::string const &what) {
+        return std::runtime_error("Checkpointer : " + what + " : " + std::strerror(errno));
+    }
+
+    void Checkpointer::State::wait(bool stall) {
+        auto const start = std::chrono::steady_clock::now();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!busy)
+            return;
+
+        done.wait(lock, [&] { return !busy; });
+
+        if (stall) {
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            stats.stall += seconds;
+            stats.max_stall = std::max(stats.max_stall, seconds);
+        }
+    }
+
+    void Checkpointer::State::stalled(double seconds) {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.stall += seconds;
+        stats.max_stall = std::max(stats.max_stall, seconds);
+    }
+
+    Checkpointer::Checkpointer(std::string const &directory, std::string const &prefix, size_t keep)
+        : m_directory(directory), m_prefix(prefix), m_keep(keep), m_state(std::make_shared<State>()) {
+        if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST)
+            throw systemError("mkdir " + directory);
+
+        m_thread = std::thread(&Checkpointer::work, this);
+    }
+
+    Checkpointer::~Checkpointer() {
+        {
+            std::lock_guard<std::mutex> lock(m_state->mutex);
+            m_state->stop = true;
+        }
+        m_state->wake.notify_one();
+        m_thread.join();
+    }
+
+    void Checkpointer::work() {
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(m_state->mutex);
+                m_state->wake.wait(lock, [&] { return m_state->stop || m_state->busy; });
+
+                // une écriture demandée avant l'arrêt est terminée
+                if (!m_state->busy)
+                    return;
+            }
+
+            auto const start = std::chrono::steady_clock::now();
+            std::string error;
+
+            try {
+                write(m_state->job);
+            } catch (std::exception const &e) {
+                error = e.what();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_state->mutex);
+                CheckpointerStats &stats = m_state->stats;
+
+                if (error.empty()) {
+                    stats.written++;
+                    stats.write = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                    stats.bytes = m_state->job.header.file_size;
+                    stats.generation = m_state->job.header.generation;
+                    stats.unscored = m_state->job.unscored;
+                    m_state->latest = path(m_state->job.header.generation);
+                } else {
+                    stats.failed++;
+                    stats.error = error;
+                }
+
+                m_state->busy = false;
+            }
+            m_state->done.notify_all();
+        }
+    }
+
+    void Checkpointer::write(Job const &job) {
+        std::string const target = path(job.header.generation);
+        std::string const temporary = target + ".tmp";
+
+        try {
+            checkpoint::write(job.header, job.genomes, job.scores, temporary, true);
+        } catch (...) {
+            unlink(temporary.c_str());
+            throw;
+        }
+
+        if (std::rename(temporary.c_str(), target.c_str()) != 0) {
+            std::runtime_error error = systemError("rename " + temporary);
+            unlink(temporary.c_str());
+            throw error;
+        }
+
+        // le renommage lui-même doit survivre à un arrêt brutal
+        int fd = open(m_directory.c_str(), O_RDONLY | O_DIRECTORY);
+        if (fd < 0)
+            throw systemError("open " + m_directory);
+
+        int res = fsync(fd);
+        close(fd);
+        if (res != 0)
+            throw systemError("fsync " + m_directory);
+
+        prune();
+    }
+
+    void Checkpointer::prune() {
+        if (m_keep == 0)
+            return;
+
+        DIR *dir = opendir(m_directory.c_str());
+        if (dir == nullptr)
+            throw systemError("opendir " + m_directory);
+
+        // prefix-<génération>.ckpt, les fichiers temporaires et étrangers sont ignorés
+        std::vector<std::pair<uint64_t, std::string>> files;
+        std::string const head = m_prefix + "-";
+
+        while (dirent *entry = readdir(dir)) {
+            std::string name = entry->d_name;
+
+            if (name.size() <= head.size() + 5 || name.compare(0, head.size(), head) != 0 || name.compare(name.size() - 5, 5, ".ckpt") != 0)
+                continue;
+
+            std::string digits = name.substr(head.size(), name.size() - head.size() - 5);
+            if (!std::all_of(digits.begin(), digits.end(), [](char c) { return c >= '0' && c <= '9'; }))
+                continue;
+
+            files.push_back({std::stoull(digits), name});
+        }
+        closedir(dir);
+
+        if (files.size() <= m_keep)
+            return;
+
+        std::sort(files.begin(), files.end());
+        for (size_t i = 0; i + m_keep < files.size(); i++)
+            unlink((m_directory + "/" + files[i].second).c_str());
+    }
+
+    void Checkpointer::wait() {
+        m_state->wait(false);
+    }
+
+    CheckpointerStats Checkpointer::stats() const {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        return m_state->stats;
+    }
+
+    std::string Checkpointer::latest() const {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        return m_state->latest;
+    }
+
+    std::string Checkpointer::path(uint64_t generation) const {
+        return checkpoint::path(m_directory, m_prefix, generation);
+    }
+
+} // namespace neuralnetwork
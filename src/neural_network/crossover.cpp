@@ -0,0 +1,188 @@
+#include "neural_network/crossover.hpp"
+#include "neural_network/kernels.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define NEURAL_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+namespace neuralnetwork
+{
+
+    namespace recombination
+    {
+
+        template <typename Scalar>
+        static void copy(Scalar *dst, Scalar const *src, size_t n) {
+            if (dst != src && n != 0)
+                std::memmove(dst, src, n * sizeof(Scalar));
+        }
+
+        template <typename Scalar>
+        void onePoint(util::Span<Scalar> child, util::Span<Scalar const> first, util::Span<Scalar const> second, size_t cut) {
+            size_t n = child.size();
+            cut = std::min(cut, n);
+
+            copy(child.data(), first.data(), cut);
+            copy(child.data() + cut, second.data() + cut, n - cut);
+        }
+
+        template <typename Scalar>
+        void twoPoint(util::Span<Scalar> child, util::Span<Scalar const> first, util::Span<Scalar const> second, size_t begin, size_t end) {
+            size_t n = child.size();
+            end = std::min(end, n);
+            begin = std::min(begin, end);
+
+            copy(child.data(), first.data(), begin);
+            copy(child.data() + begin, second.data() + begin, end - begin);
+            copy(child.data() + end, first.data() + end, n - end);
+        }
+
+        // bit i de bits à 1 : paramètre i du premier parent
+        template <typename Scalar>
+        static void blendScalar(Scalar *child, Scalar const *first, Scalar const *second, uint64_t bits, size_t n) {
+            for (size_t i = 0; i < n; i++)
+                child[i] = (bits >> i) & 1 ? first[i] : second[i];
+        }
+
+#ifdef NEURAL_KERNELS_X86
+        __attribute__((target("avx2")))
+        static void blendAVX2(double *child, double const *first, double const *second, uint64_t bits) {
+            __m256i const lanes = _mm256_setr_epi64x(1, 2, 4, 8);
+
+            for (size_t i = 0; i < 64; i += 4) {
+                __m256i m = _mm256_and_si256(_mm256_set1_epi64x((long long)(bits >> i)), lanes);
+                __m256d mask = _mm256_castsi256_pd(_mm256_cmpeq_epi64(m, lanes));
+
+                __m256d r = _mm256_blendv_pd(_mm256_loadu_pd(second + i), _mm256_loadu_pd(first + i), mask);
+                _mm256_storeu_pd(child + i, r);
+            }
+        }
+
+        __attribute__((target("avx2")))
+        static void blendAVX2(float *child, float const *first, float const *second, uint64_t bits) {
+            __m256i const lanes = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+
+            for (size_t i = 0; i < 64; i += 8) {
+                __m256i m = _mm256_and_si256(_mm256_set1_epi32((int)((bits >> i) & 0xFF)), lanes);
+                __m256 mask = _mm256_castsi256_ps(_mm256_cmpeq_epi32(m, lanes));
+
+                __m256 r = _mm256_blendv_ps(_mm256_loadu_ps(second + i), _mm256_loadu_ps(first + i), mask);
+                _mm256_storeu_ps(child + i, r);
+            }
+        }
+#endif
+
+        template <typename Scalar>
+        void uniform(util::Span<Scalar> child, util::Span<Scalar const> first, util::Span<Scalar const> second, util::Random &rng) {
+            size_t n = child.size();
+            size_t full = n & ~size_t(63);
+
+#ifdef NEURAL_KERNELS_X86
+            if (kernels::isa() >= kernels::isa_t::AVX2) {
+                for (size_t i = 0; i < full; i += 64)
+                    blendAVX2(child.data() + i, first.data() + i, second.data() + i, rng());
+            } else
+#endif
+            {
+                for (size_t i = 0; i < full; i += 64)
+                    blendScalar(child.data() + i, first.data() + i, second.data() + i, rng(), 64);
+            }
+
+            if (full < n)
+                blendScalar(child.data() + full, first.data() + full, second.data() + full, rng(), n - full);
+        }
+
+        template <typename Scalar>
+        void arithmetic(util::Span<Scalar> child, util::Span<Scalar const> first, util::Span<Scalar const> second, double alpha) {
+            // boucle simple, vectorisée par le compilateur, même arrondi quel que soit le processeur
+            Scalar const a = alpha;
+            Scalar const b = 1 - alpha;
+
+            for (size_t i = 0; i < child.size(); i++)
+                child[i] = a * first[i] + b * second[i];
+        }
+
+        template <typename Scalar>
+        void layer(util::Span<Scalar> child, util::Span<Scalar const> first, util::Span<Scalar const> second,
+                   util::Span<size_t const> blocks, double rate, util::Random &rng) {
+            size_t n = child.size();
+
+            for (size_t l = 0; l < blocks.size(); l++) {
+                size_t begin = blocks[l];
+                size_t end = l + 1 < blocks.size() ? blocks[l + 1] : n;
+
+                Scalar const *parent = rng.uniform() < rate ? first.data() : second.data();
+                copy(child.data() + begin, parent + begin, end - begin);
+            }
+        }
+
+        void twoPointRange(size_t n, double rate, util::Random &rng, size_t &begin, size_t &end) {
+            size_t length = std::min<size_t>(n * (1 - rate), n);
+            begin = std::min<size_t>(rng.uniform() * (n - length + 1), n - length);
+            end = begin + length;
+        }
+
+        template <typename Scalar>
+        void apply(crossover_t type, util::Span<Scalar> child, util::Span<Scalar const> first, util::Span<Scalar const> second,
+                   double rate, util::Span<size_t const> blocks, util::Random &rng) {
+            size_t n = child.size();
+
+            switch (type) {
+                case crossover_t::OnePoint:
+                    onePoint(child, first, second, (size_t)(n * rate));
+                    break;
+
+                case crossover_t::TwoPoint: {
+                    size_t begin, end;
+                    twoPointRange(n, rate, rng, begin, end);
+                    twoPoint(child, first, second, begin, end);
+                    break;
+                }
+
+                case crossover_t::Uniform:
+                    uniform(child, first, second, rng);
+                    break;
+
+                case crossover_t::Arithmetic:
+                    arithmetic(child, first, second, rate);
+                    break;
+
+                case crossover_t::Layer:
+                    layer(child, first, second, blocks, rate, rng);
+                    break;
+            }
+        }
+
+        char const *toString(crossover_t type) {
+            switch (type) {
+                case crossover_t::OnePoint: return "one-point";
+                case crossover_t::TwoPoint: return "two-point";
+                case crossover_t::Uniform: return "uniform";
+                case crossover_t::Arithmetic: return "arithmetic";
+                case crossover_t::Layer: return "layer";
+            }
+            return "unknown";
+        }
+
+#define NEURAL_CROSSOVER_INSTANTIATE(Scalar)                                                                                   \
+    template void onePoint<Scalar>(util::Span<Scalar>, util::Span<Scalar const>, util::Span<Scalar const>, size_t);          \
+    template void twoPoint<Scalar>(util::Span<Scalar>, util::Span<Scalar const>, util::Span<Scalar const>, size_t, size_t);  \
+    template void uniform<Scalar>(util::Span<Scalar>, util::Span<Scalar const>, util::Span<Scalar const>, util::Random &);   \
+    template void arithmetic<Scalar>(util::Span<Scalar>, util::Span<Scalar const>, util::Span<Scalar const>, double);       \
+    template void layer<Scalar>(util::Span<Scalar>, util::Span<Scalar const>, util::Span<Scalar const>,                     \
+                                util::Span<size_t const>, double, util::Random &);                                          \
+    template void apply<Scalar>(crossover_t, util::Span<Scalar>, util::Span<Scalar const>, util::Span<Scalar const>,        \
+                                double, util::Span<size_t const>, util::Random &);
+
+        NEURAL_CROSSOVER_INSTANTIATE(float)
+        NEURAL_CROSSOVER_INSTANTIATE(double)
+
+#undef NEURAL_CROSSOVER_INSTANTIATE
+
+    } // namespace recombination
+
+} // namespace neuralnetwork
@@ -0,0 +1,327 @@
+#include "neural_network/delta.hpp"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+
+#include <sys/stat.h>
+
+namespace neuralnetwork
+{
+
+    namespace delta
+    {
+        // plages : varint (longueur << 2 | type)
+        static unsigned const FIRST = 0, SECOND = 1, LITERAL = 2;
+
+        static void putVarint(std::vector<uint8_t> &out, uint64_t value) {
+            while (value >= 0x80) {
+                out.push_back(uint8_t(value) | 0x80);
+                value >>= 7;
+            }
+            out.push_back(uint8_t(value));
+        }
+
+        static uint64_t getVarint(uint8_t const *&data, uint8_t const *end) {
+            uint64_t value = 0;
+
+            for (unsigned shift = 0; shift < 64; shift += 7) {
+                if (data == end)
+                    throw std::runtime_error("delta : varint tronque");
+
+                uint8_t byte = *data++;
+                value |= uint64_t(byte & 0x7F) << shift;
+                if (!(byte & 0x80))
+                    return value;
+            }
+            throw std::runtime_error("delta : varint invalide");
+        }
+
+        // les valeurs sont comparées et combinées comme des mots de même taille
+        template <typename Word>
+        static void encodeWords(Word const *child, Word const *first, Word const *second, size_t n, std::vector<uint8_t> &out) {
+            unsigned side = FIRST; // parent de la dernière plage copiée, référence des littéraux
+            size_t k = 0;
+
+            while (k < n) {
+                Word const *ref = side == FIRST ? first : second;
+                Word const *other = side == FIRST ? second : first;
+
+                size_t end = k;
+                while (end < n && child[end] == ref[end])
+                    end++;
+
+                if (end > k) {
+                    putVarint(out, (uint64_t)(end - k) << 2 | side);
+                    k = end;
+                    continue;
+                }
+
+                if (child[k] == other[k]) {
+                    side ^= 1;
+                    continue;
+                }
+
+                end = k;
+                while (end < n && child[end] != first[end] && child[end] != second[end])
+                    end++;
+
+                putVarint(out, (uint64_t)(end - k) << 2 | LITERAL);
+                for (; k < end; k++)
+                    putVarint(out, child[k] ^ ref[k]);
+            }
+        }
+
+        template <typename Word>
+        static void decodeWords(uint8_t const *data, size_t size, Word const *first, Word const *second, Word *child, size_t n) {
+            uint8_t const *end = data + size;
+            unsigned side = FIRST;
+            size_t k = 0;
+
+            while (k < n) {
+                uint64_t op = getVarint(data, end);
+                uint64_t length = op >> 2;
+                unsigned type = op & 3;
+
+                if (length == 0 || length > n - k || type > LITERAL)
+                    throw std::runtime_error("delta : plage invalide");
+
+                if (type != LITERAL) {
+                    side = type;
+                    std::memcpy(child + k, (side == FIRST ? first : second) + k, length * sizeof(Word));
+                    k += length;
+                } else {
+                    Word const *ref = side == FIRST ? first : second;
+                    for (size_t e = k + length; k < e; k++)
+                        child[k] = ref[k] ^ (Word)getVarint(data, end);
+                }
+            }
+
+            if (data != end)
+                throw std::runtime_error("delta : octets en trop");
+        }
+
+        void encode(void const *child, void const *first, void const *second, size_t n, uint32_t scalar_size, std::vector<uint8_t> &out) {
+            if (scalar_size == sizeof(uint32_t))
+                encodeWords(static_cast<uint32_t const *>(child), static_cast<uint32_t const *>(first), static_cast<uint32_t const *>(second), n,
+                            out);
+            else
+                encodeWords(static_cast<uint64_t const *>(child), static_cast<uint64_t const *>(first), static_cast<uint64_t const *>(second), n,
+                            out);
+        }
+
+        void decode(uint8_t const *data, size_t size, void const *first, void const *second, void *child, size_t n, uint32_t scalar_size) {
+            if (scalar_size == sizeof(uint32_t))
+                decodeWords(data, size, static_cast<uint32_t const *>(first), static_cast<uint32_t const *>(second), static_cast<uint32_t *>(child),
+                            n);
+            else
+                decodeWords(data, size, static_cast<uint64_t const *>(first), static_cast<uint64_t const *>(second), static_cast<uint64_t *>(child),
+                            n);
+        }
+
+        // last : fin des données, sinon size est un multiple de 8 et l'empreinte continue au bloc suivant
+        static uint64_t checksum(uint64_t h, void const *data, size_t size, bool last = true) {
+            uint8_t const *bytes = static_cast<uint8_t const *>(data);
+
+            for (; size >= 8; size -= 8, bytes += 8) {
+                uint64_t word;
+                std::memcpy(&word, bytes, 8);
+                h = util::mix64(h ^ word);
+            }
+
+            if (!last)
+                return h;
+
+            uint64_t tail = 0;
+            if (size > 0)
+                std::memcpy(&tail, bytes, size);
+            return util::mix64(h ^ tail ^ (uint64_t)size << 56);
+        }
+
+        static uint64_t checksum(Header const &header) {
+            return checksum(VERSION, &header, offsetof(Header, checksum));
+        }
+
+        static bool exists(std::string const &path) {
+            struct stat info;
+            return stat(path.c_str(), &info) == 0;
+        }
+
+        // applique le delta path à previous
+        static Snapshot applyDelta(Snapshot const &previous, std::string const &path) {
+            util::MappedFile file = util::MappedFile::open(path);
+            Header const &header = *static_cast<Header const *>(file.data());
+            char const *bytes = static_cast<char const *>(file.data());
+
+            if (file.size() < sizeof(Header) || std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+                throw std::runtime_error("delta : fichier non reconnu " + path);
+            if (header.endian != checkpoint::ENDIAN || header.version != VERSION || header.header_size != sizeof(Header))
+                throw std::runtime_error("delta : version ou ordre des octets non supporte " + path);
+            if (header.checksum != checksum(header))
+                throw std::runtime_error("delta : en-tete corrompu " + path);
+
+            uint64_t const n = header.population;
+            if (header.scores_offset != sizeof(Header) || header.index_offset != header.scores_offset + n * sizeof(double) ||
+                header.payload_offset != header.index_offset + (n + 1) * sizeof(uint64_t) ||
+                header.file_size != header.payload_offset + header.payload_size || header.file_size > file.size())
+                throw std::runtime_error("delta : fichier tronque ou offsets incoherents " + path);
+
+            if (header.data_checksum != checksum(0, bytes + header.scores_offset, header.file_size - header.scores_offset))
+                throw std::runtime_error("delta : donnees corrompues " + path);
+
+            if (n != previous.header.population || header.nparams != previous.header.nparams ||
+                header.scalar_size != previous.header.scalar_size || header.generation != previous.header.generation + 1)
+                throw std::runtime_error("delta : " + path + " ne suit pas la generation " + std::to_string(previous.header.generation));
+
+            Snapshot res;
+            res.header = checkpoint::header(previous.header.params.decode(), n, header.nparams, header.scalar_size, header.generation);
+            res.genomes.resize(previous.genomes.size());
+            res.scores.resize(n);
+            std::memcpy(res.scores.data(), bytes + header.scores_offset, n * sizeof(double));
+
+            std::vector<uint64_t> index(n + 1);
+            std::memcpy(index.data(), bytes + header.index_offset, index.size() * sizeof(uint64_t));
+
+            uint8_t const *payload = reinterpret_cast<uint8_t const *>(bytes + header.payload_offset);
+            size_t const genome_size = header.nparams * header.scalar_size;
+
+            for (size_t i = 0; i < n; i++) {
+                if (index[i] > index[i + 1] || index[i + 1] > header.payload_size)
+                    throw std::runtime_error("delta : index incoherent " + path);
+
+                uint8_t const *data = payload + index[i];
+                uint8_t const *end = payload + index[i + 1];
+
+                uint64_t first = getVarint(data, end);
+                uint64_t second = getVarint(data, end);
+                if (first >= n || second >= n)
+                    throw std::runtime_error("delta : parent hors de la population " + path);
+
+                decode(data, end - data, previous.genome(first), previous.genome(second), res.genomes.data() + i * genome_size, header.nparams,
+                       header.scalar_size);
+            }
+
+            return res;
+        }
+
+        Snapshot reconstruct(std::string const &directory, std::string const &prefix, uint64_t generation) {
+            uint64_t base = generation;
+            while (!exists(checkpoint::path(directory, prefix, base))) {
+                if (base == 0)
+                    throw std::runtime_error("delta : aucune base avant la generation " + std::to_string(generation));
+                base--;
+            }
+
+            MappedCheckpoint checkpoint(checkpoint::path(directory, prefix, base));
+            checkpoint.prefetch();
+
+            checkpoint::Header const &header = checkpoint.header();
+            size_t const genome_size = header.nparams * header.scalar_size;
+
+            Snapshot snapshot;
+            snapshot.header = header;
+            snapshot.genomes.resize(header.population * genome_size);
+
+            util::Span<double const> scores = checkpoint.scores();
+            snapshot.scores.assign(scores.begin(), scores.end());
+
+            for (size_t i = 0; i < header.population; i++)
+                std::memcpy(snapshot.genomes.data() + i * genome_size, checkpoint.data(i), genome_size);
+
+            for (uint64_t g = base + 1; g <= generation; g++)
+                snapshot = applyDelta(snapshot, checkpoint::path(directory, prefix, g, "delta"));
+
+            return snapshot;
+        }
+
+        void save(Snapshot const &snapshot, std::string const &path) {
+            std::vector<void const *> genomes(snapshot.header.population);
+            for (size_t i = 0; i < genomes.size(); i++)
+                genomes[i] = snapshot.genome(i);
+
+            checkpoint::write(snapshot.header, genomes, snapshot.scores, path);
+        }
+    } // namespace delta
+
+    CheckpointHistory::CheckpointHistory(std::string const &directory, std::string const &prefix, uint64_t interval)
+        : m_directory(directory), m_prefix(prefix), m_interval(interval == 0 ? 1 : interval), m_has_previous(false) {
+        if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST)
+            throw std::runtime_error("CheckpointHistory : mkdir " + directory + " : " + std::strerror(errno));
+    }
+
+    void CheckpointHistory::record(checkpoint::Header const &header, std::vector<void const *> const &genomes,
+                                   std::vector<std::pair<size_t, size_t>> const &parents, std::vector<double> const &scores) {
+        uint64_t const n = header.population;
+        size_t const genome_size = header.nparams * header.scalar_size;
+
+        bool const base = !m_has_previous || header.generation % m_interval == 0 || header.generation != m_previous.header.generation + 1 ||
+                          n != m_previous.header.population || header.nparams != m_previous.header.nparams ||
+                          header.scalar_size != m_previous.header.scalar_size;
+
+        if (base) {
+            checkpoint::write(header, genomes, scores, checkpoint::path(m_directory, m_prefix, header.generation));
+
+            m_stats.bases++;
+            m_stats.bytes += header.file_size;
+        } else {
+            m_payload.clear();
+            m_index.resize(n + 1);
+
+            for (size_t i = 0; i < n; i++) {
+                // parents inconnus (hors de la génération précédente) : le génome de même indice
+                size_t first = parents[i].first < n ? parents[i].first : i;
+                size_t second = parents[i].second < n ? parents[i].second : i;
+
+                m_index[i] = m_payload.size();
+                delta::putVarint(m_payload, first);
+                delta::putVarint(m_payload, second);
+                delta::encode(genomes[i], m_previous.genome(first), m_previous.genome(second), header.nparams, header.scalar_size, m_payload);
+            }
+            m_index[n] = m_payload.size();
+
+            delta::Header out;
+            std::memset(&out, 0, sizeof(out));
+
+            std::memcpy(out.magic, delta::MAGIC, sizeof(delta::MAGIC));
+            out.version = delta::VERSION;
+            out.endian = checkpoint::ENDIAN;
+            out.header_size = sizeof(delta::Header);
+            out.scalar_size = header.scalar_size;
+            out.population = n;
+            out.nparams = header.nparams;
+            out.generation = header.generation;
+            out.scores_offset = sizeof(delta::Header);
+            out.index_offset = out.scores_offset + n * sizeof(double);
+            out.payload_offset = out.index_offset + (n + 1) * sizeof(uint64_t);
+            out.payload_size = m_payload.size();
+            out.file_size = out.payload_offset + out.payload_size;
+
+            // scores, index et payload sont contigus dans le fichier, une seule empreinte
+            uint64_t h = delta::checksum(0, scores.data(), n * sizeof(double), false);
+            h = delta::checksum(h, m_index.data(), (n + 1) * sizeof(uint64_t), false);
+            out.data_checksum = delta::checksum(h, m_payload.data(), m_payload.size());
+            out.checksum = delta::checksum(out);
+
+            checkpoint::Writer writer(checkpoint::path(m_directory, m_prefix, header.generation, "delta"));
+            writer.write(&out, sizeof(out));
+            writer.write(scores.data(), n * sizeof(double));
+            writer.write(m_index.data(), (n + 1) * sizeof(uint64_t));
+            writer.write(m_payload.data(), m_payload.size());
+            writer.close();
+
+            m_stats.deltas++;
+            m_stats.bytes += out.file_size;
+        }
+
+        m_stats.full_bytes += header.file_size;
+
+        // nouvelle référence
+        m_previous.header = header;
+        m_previous.genomes.resize(n * genome_size);
+        for (size_t i = 0; i < n; i++)
+            std::memcpy(m_previous.genomes.data() + i * genome_size, genomes[i], genome_size);
+        m_previous.scores = scores;
+        m_has_previous = true;
+    }
+
+} // namespace neuralnetwork
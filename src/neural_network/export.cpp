@@ -0,0 +1,116 @@
+#include "neural_network/export.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "neural_network/checkpoint.hpp"
+#include "neural_network/quantized.hpp"
+
+namespace neuralnetwork
+{
+
+    static_assert(frozen::Sigmoid == (uint32_t)activation_t::Sigmoid && frozen::FastSigmoid == (uint32_t)activation_t::FastSigmoid &&
+                      frozen::RationalSigmoid == (uint32_t)activation_t::RationalSigmoid &&
+                      frozen::SigmoidLut == (uint32_t)activation_t::SigmoidLut && frozen::Tanh == (uint32_t)activation_t::Tanh &&
+                      frozen::ReLU == (uint32_t)activation_t::ReLU && frozen::Identity == (uint32_t)activation_t::Identity,
+                  "frozen::activation : identifiants differents de activation_t");
+
+    static size_t alignUp(size_t value, size_t align) {
+        return (value + align - 1) / align * align;
+    }
+
+    template <typename Scalar>
+    std::vector<unsigned char> freeze(Topology const &topology, util::Span<Scalar const> params, frozen::format_t format) {
+        size_t const nlayers = topology.sizes.size();
+
+        if (params.size() != topology.nparams)
+            throw std::invalid_argument("freeze : nombre de parametres different de la topologie");
+
+        bool const int8 = format == frozen::format_t::Int8;
+        std::vector<frozen::Layer> layers(nlayers);
+        size_t offset = sizeof(frozen::Header) + nlayers * sizeof(frozen::Layer);
+        uint32_t max_width = 0;
+
+        for (size_t l = 0; l < nlayers; l++) {
+            if ((uint32_t)topology.activations[l] > frozen::Identity)
+                throw std::invalid_argument("freeze : activation personnalisee non exportable");
+
+            frozen::Layer &layer = layers[l];
+            layer = {};
+            layer.size = topology.sizes[l];
+            layer.activation = (uint32_t)topology.activations[l];
+            max_width = std::max(max_width, layer.size);
+
+            if (l == 0)
+                continue;
+
+            layer.stride = int8 ? alignUp(topology.sizes[l - 1], frozen::INT8_ROW) : topology.sizes[l - 1];
+            layer.offset = offset = alignUp(offset, frozen::ALIGN);
+            offset += int8 ? (size_t)layer.size * layer.stride + 2 * layer.size * sizeof(float)
+                           : ((size_t)layer.size * layer.stride + layer.size) * sizeof(float);
+        }
+
+        std::vector<unsigned char> data(offset, 0);
+
+        frozen::Header header = {};
+        std::memcpy(header.magic, frozen::MAGIC, sizeof(frozen::MAGIC));
+        header.version = frozen::VERSION;
+        header.endian = frozen::ENDIAN;
+        header.format = (uint32_t)format;
+        header.nlayers = nlayers;
+        header.max_width = max_width;
+        header.size = data.size();
+
+        std::memcpy(data.data() + sizeof(header), layers.data(), nlayers * sizeof(frozen::Layer));
+
+        for (size_t l = 1; l < nlayers; l++) {
+            frozen::Layer const &layer = layers[l];
+            size_t const inputs = topology.sizes[l - 1];
+
+            Scalar const *weights = params.data() + topology.param_offsets[l];
+            Scalar const *bias = weights + topology.nweights(l);
+            unsigned char *block = data.data() + layer.offset;
+
+            if (int8) {
+                int8_t *quantized = reinterpret_cast<int8_t *>(block);
+                float *scales = reinterpret_cast<float *>(block + (size_t)layer.size * layer.stride);
+                float *biases = scales + layer.size;
+
+                for (size_t i = 0; i < layer.size; i++) {
+                    scales[i] = quantizeRow(weights + i * inputs, inputs, quantized + i * layer.stride);
+                    biases[i] = bias[i];
+                }
+            } else {
+                float *out = reinterpret_cast<float *>(block);
+
+                for (size_t i = 0; i < layer.size; i++)
+                    for (size_t j = 0; j < inputs; j++)
+                        out[i * layer.stride + j] = weights[i * inputs + j];
+
+                for (size_t i = 0; i < layer.size; i++)
+                    out[(size_t)layer.size * layer.stride + i] = bias[i];
+            }
+        }
+
+        header.checksum = frozen::checksum(data.data() + sizeof(header), data.size() - sizeof(header));
+        std::memcpy(data.data(), &header, sizeof(header));
+
+        return data;
+    }
+
+    template <typename Scalar>
+    void exportNetwork(BasicNeuralNetwork<Scalar> const &network, std::string const &path, frozen::format_t format) {
+        std::vector<unsigned char> data = freeze(network, format);
+
+        checkpoint::Writer writer(path, data.size());
+        writer.write(data.data(), data.size());
+        writer.close();
+    }
+
+    template std::vector<unsigned char> freeze<float>(Topology const &, util::Span<float const>, frozen::format_t);
+    template std::vector<unsigned char> freeze<double>(Topology const &, util::Span<double const>, frozen::format_t);
+    template void exportNetwork<float>(BasicNeuralNetwork<float> const &, std::string const &, frozen::format_t);
+    template void exportNetwork<double>(BasicNeuralNetwork<double> const &, std::string const &, frozen::format_t);
+
+} // namespace neuralnetwork
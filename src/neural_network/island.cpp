@@ -0,0 +1,9 @@
+#include "neural_network/island.hpp"
+
+namespace neuralnetwork
+{
+
+    template class BasicIslands<NeuralNetworkf>;
+    template class BasicIslands<NeuralNetwork>;
+
+}
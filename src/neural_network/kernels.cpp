@@ -0,0 +1,525 @@
+#include "neural_network/kernels.hpp"
+
+#include <atomic>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define NEURAL_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+namespace neuralnetwork
+{
+    namespace kernels
+    {
+
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /////                                   Scalar                                           /////
+        //////////////////////////////////////////////////////////////////////////////////////////////
+
+        template <typename Scalar>
+        static void denseScalar(Scalar const *weights, Scalar const *bias, Scalar const *in, Scalar *out, size_t rows, size_t cols) {
+            for (size_t i = 0; i < rows; i++) {
+                Scalar s = bias[i];
+                Scalar const *w = weights + i * cols;
+
+                for (size_t j = 0; j < cols; j++)
+                    s += w[j] * in[j];
+
+                out[i] = s;
+            }
+        }
+
+        template <typename Scalar>
+        static void multiplyAddScalar(Scalar *acc, Scalar const *a, Scalar const *b, size_t n) {
+            for (size_t i = 0; i < n; i++)
+                acc[i] += a[i] * b[i];
+        }
+
+        static void dotInt8Scalar(int8_t const *weights, uint8_t const *in, int32_t *out, size_t rows, size_t stride) {
+            for (size_t i = 0; i < rows; i++) {
+                int32_t s = 0;
+                int8_t const *w = weights + i * stride;
+
+                for (size_t j = 0; j < stride; j++)
+                    s += w[j] * in[j];
+
+                out[i] = s;
+            }
+        }
+
+#ifdef NEURAL_KERNELS_X86
+
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /////                                    SSE2                                            /////
+        //////////////////////////////////////////////////////////////////////////////////////////////
+
+        __attribute__((target("sse2")))
+        static void denseSSE2(double const *weights, double const *bias, double const *in, double *out, size_t rows, size_t cols) {
+            for (size_t i = 0; i < rows; i++) {
+                double const *w = weights + i * cols;
+
+                __m128d acc0 = _mm_setzero_pd();
+                __m128d acc1 = _mm_setzero_pd();
+                size_t j = 0;
+
+                for (; j + 4 <= cols; j += 4) {
+                    acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(w + j), _mm_loadu_pd(in + j)));
+                    acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_loadu_pd(w + j + 2), _mm_loadu_pd(in + j + 2)));
+                }
+                for (; j + 2 <= cols; j += 2)
+                    acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(w + j), _mm_loadu_pd(in + j)));
+
+                acc0 = _mm_add_pd(acc0, acc1);
+                double s = bias[i] + _mm_cvtsd_f64(_mm_add_sd(acc0, _mm_unpackhi_pd(acc0, acc0)));
+
+                for (; j < cols; j++)
+                    s += w[j] * in[j];
+
+                out[i] = s;
+            }
+        }
+
+        __attribute__((target("sse2")))
+        static void multiplyAddSSE2(double *acc, double const *a, double const *b, size_t n) {
+            size_t i = 0;
+
+            for (; i + 2 <= n; i += 2)
+                _mm_storeu_pd(acc + i, _mm_add_pd(_mm_loadu_pd(acc + i), _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i))));
+
+            for (; i < n; i++)
+                acc[i] += a[i] * b[i];
+        }
+
+        __attribute__((target("sse2")))
+        static void denseSSE2(float const *weights, float const *bias, float const *in, float *out, size_t rows, size_t cols) {
+            for (size_t i = 0; i < rows; i++) {
+                float const *w = weights + i * cols;
+
+                __m128 acc0 = _mm_setzero_ps();
+                __m128 acc1 = _mm_setzero_ps();
+                size_t j = 0;
+
+                for (; j + 8 <= cols; j += 8) {
+                    acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(w + j), _mm_loadu_ps(in + j)));
+                    acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(w + j + 4), _mm_loadu_ps(in + j + 4)));
+                }
+                for (; j + 4 <= cols; j += 4)
+                    acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(w + j), _mm_loadu_ps(in + j)));
+
+                acc0 = _mm_add_ps(acc0, acc1);
+                acc0 = _mm_add_ps(acc0, _mm_movehl_ps(acc0, acc0));
+                acc0 = _mm_add_ss(acc0, _mm_shuffle_ps(acc0, acc0, 1));
+                float s = bias[i] + _mm_cvtss_f32(acc0);
+
+                for (; j < cols; j++)
+                    s += w[j] * in[j];
+
+                out[i] = s;
+            }
+        }
+
+        __attribute__((target("sse2")))
+        static void multiplyAddSSE2(float *acc, float const *a, float const *b, size_t n) {
+            size_t i = 0;
+
+            for (; i + 4 <= n; i += 4)
+                _mm_storeu_ps(acc + i, _mm_add_ps(_mm_loadu_ps(acc + i), _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i))));
+
+            for (; i < n; i++)
+                acc[i] += a[i] * b[i];
+        }
+
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /////                                    AVX2                                            /////
+        //////////////////////////////////////////////////////////////////////////////////////////////
+
+        __attribute__((target("avx2,fma")))
+        static double horizontalSum(__m256d v) {
+            __m128d low = _mm256_castpd256_pd128(v);
+            __m128d high = _mm256_extractf128_pd(v, 1);
+            low = _mm_add_pd(low, high);
+            return _mm_cvtsd_f64(_mm_add_sd(low, _mm_unpackhi_pd(low, low)));
+        }
+
+        __attribute__((target("avx2,fma")))
+        static void denseAVX2(double const *weights, double const *bias, double const *in, double *out, size_t rows, size_t cols) {
+            for (size_t i = 0; i < rows; i++) {
+                double const *w = weights + i * cols;
+
+                __m256d acc0 = _mm256_setzero_pd();
+                __m256d acc1 = _mm256_setzero_pd();
+                size_t j = 0;
+
+                for (; j + 8 <= cols; j += 8) {
+                    acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(w + j), _mm256_loadu_pd(in + j), acc0);
+                    acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(w + j + 4), _mm256_loadu_pd(in + j + 4), acc1);
+                }
+                for (; j + 4 <= cols; j += 4)
+                    acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(w + j), _mm256_loadu_pd(in + j), acc0);
+
+                double s = bias[i] + horizontalSum(_mm256_add_pd(acc0, acc1));
+
+                for (; j < cols; j++)
+                    s += w[j] * in[j];
+
+                out[i] = s;
+            }
+        }
+
+        __attribute__((target("avx2,fma")))
+        static void multiplyAddAVX2(double *acc, double const *a, double const *b, size_t n) {
+            size_t i = 0;
+
+            for (; i + 4 <= n; i += 4)
+                _mm256_storeu_pd(acc + i, _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), _mm256_loadu_pd(acc + i)));
+
+            for (; i < n; i++)
+                acc[i] += a[i] * b[i];
+        }
+
+        __attribute__((target("avx2,fma")))
+        static float horizontalSum(__m256 v) {
+            __m128 low = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+            low = _mm_add_ps(low, _mm_movehl_ps(low, low));
+            return _mm_cvtss_f32(_mm_add_ss(low, _mm_shuffle_ps(low, low, 1)));
+        }
+
+        __attribute__((target("avx2,fma")))
+        static void denseAVX2(float const *weights, float const *bias, float const *in, float *out, size_t rows, size_t cols) {
+            for (size_t i = 0; i < rows; i++) {
+                float const *w = weights + i * cols;
+
+                __m256 acc0 = _mm256_setzero_ps();
+                __m256 acc1 = _mm256_setzero_ps();
+                size_t j = 0;
+
+                for (; j + 16 <= cols; j += 16) {
+                    acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(w + j), _mm256_loadu_ps(in + j), acc0);
+                    acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(w + j + 8), _mm256_loadu_ps(in + j + 8), acc1);
+                }
+                for (; j + 8 <= cols; j += 8)
+                    acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(w + j), _mm256_loadu_ps(in + j), acc0);
+
+                float s = bias[i] + horizontalSum(_mm256_add_ps(acc0, acc1));
+
+                for (; j < cols; j++)
+                    s += w[j] * in[j];
+
+                out[i] = s;
+            }
+        }
+
+        __attribute__((target("avx2,fma")))
+        static void multiplyAddAVX2(float *acc, float const *a, float const *b, size_t n) {
+            size_t i = 0;
+
+            for (; i + 8 <= n; i += 8)
+                _mm256_storeu_ps(acc + i, _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), _mm256_loadu_ps(acc + i)));
+
+            for (; i < n; i++)
+                acc[i] += a[i] * b[i];
+        }
+
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /////                                   AVX-512                                          /////
+        //////////////////////////////////////////////////////////////////////////////////////////////
+
+        // somme horizontale à la main, dans le même ordre que _mm512_reduce_add_pd/ps.
+        // Les moitiés sont extraites avec un masque plein : l'extraction simple (et les casts 512 -> 256) part
+        // d'une valeur indéfinie et déclenche -Wmaybe-uninitialized avec GCC, le code généré est le même.
+        __attribute__((target("avx512f")))
+        static inline double sumAVX512(__m512d v) {
+            __m256d half = _mm256_add_pd(_mm512_maskz_extractf64x4_pd(0xff, v, 1), _mm512_maskz_extractf64x4_pd(0xff, v, 0));
+            __m128d quarter = _mm_add_pd(_mm256_extractf128_pd(half, 1), _mm256_castpd256_pd128(half));
+            return _mm_cvtsd_f64(_mm_add_sd(quarter, _mm_unpackhi_pd(quarter, quarter)));
+        }
+
+        __attribute__((target("avx512f")))
+        static inline float sumAVX512(__m512 v) {
+            __m512d bits = _mm512_castps_pd(v);
+            __m256 half = _mm256_add_ps(_mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xff, bits, 1)),
+                                        _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xff, bits, 0)));
+            __m128 quarter = _mm_add_ps(_mm256_extractf128_ps(half, 1), _mm256_castps256_ps128(half));
+            __m128 pairs = _mm_add_ps(quarter, _mm_movehl_ps(quarter, quarter));
+            return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+        }
+
+        __attribute__((target("avx512f")))
+        static void denseAVX512(double const *weights, double const *bias, double const *in, double *out, size_t rows, size_t cols) {
+            for (size_t i = 0; i < rows; i++) {
+                double const *w = weights + i * cols;
+
+                __m512d acc = _mm512_setzero_pd();
+                size_t j = 0;
+
+                for (; j + 8 <= cols; j += 8)
+                    acc = _mm512_fmadd_pd(_mm512_loadu_pd(w + j), _mm512_loadu_pd(in + j), acc);
+
+                // reste masqué, pas de boucle scalaire
+                if (j < cols) {
+                    __mmask8 mask = (__mmask8)((1u << (cols - j)) - 1);
+                    acc = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, w + j), _mm512_maskz_loadu_pd(mask, in + j), acc);
+                }
+
+                out[i] = bias[i] + sumAVX512(acc);
+            }
+        }
+
+        __attribute__((target("avx512f")))
+        static void multiplyAddAVX512(double *acc, double const *a, double const *b, size_t n) {
+            size_t i = 0;
+
+            for (; i + 8 <= n; i += 8)
+                _mm512_storeu_pd(acc + i, _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), _mm512_loadu_pd(acc + i)));
+
+            if (i < n) {
+                __mmask8 mask = (__mmask8)((1u << (n - i)) - 1);
+                __m512d r = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, a + i), _mm512_maskz_loadu_pd(mask, b + i), _mm512_maskz_loadu_pd(mask, acc + i));
+                _mm512_mask_storeu_pd(acc + i, mask, r);
+            }
+        }
+
+        __attribute__((target("avx512f")))
+        static void denseAVX512(float const *weights, float const *bias, float const *in, float *out, size_t rows, size_t cols) {
+            for (size_t i = 0; i < rows; i++) {
+                float const *w = weights + i * cols;
+
+                __m512 acc = _mm512_setzero_ps();
+                size_t j = 0;
+
+                for (; j + 16 <= cols; j += 16)
+                    acc = _mm512_fmadd_ps(_mm512_loadu_ps(w + j), _mm512_loadu_ps(in + j), acc);
+
+                if (j < cols) {
+                    __mmask16 mask = (__mmask16)((1u << (cols - j)) - 1);
+                    acc = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, w + j), _mm512_maskz_loadu_ps(mask, in + j), acc);
+                }
+
+                out[i] = bias[i] + sumAVX512(acc);
+            }
+        }
+
+        __attribute__((target("avx512f")))
+        static void multiplyAddAVX512(float *acc, float const *a, float const *b, size_t n) {
+            size_t i = 0;
+
+            for (; i + 16 <= n; i += 16)
+                _mm512_storeu_ps(acc + i, _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), _mm512_loadu_ps(acc + i)));
+
+            if (i < n) {
+                __mmask16 mask = (__mmask16)((1u << (n - i)) - 1);
+                __m512 r = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, a + i), _mm512_maskz_loadu_ps(mask, b + i), _mm512_maskz_loadu_ps(mask, acc + i));
+                _mm512_mask_storeu_ps(acc + i, mask, r);
+            }
+        }
+
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /////                                    Int8                                            /////
+        //////////////////////////////////////////////////////////////////////////////////////////////
+
+        __attribute__((target("avx2")))
+        static inline int32_t reduceAVX2(__m256i v) {
+            __m128i s = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+            s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4E));
+            s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xB1));
+            return _mm_cvtsi128_si32(s);
+        }
+
+        // 4 lignes à la fois : chaque bloc de l'entrée est chargé une fois pour les 4
+        __attribute__((target("avx2")))
+        static void dotInt8AVX2(int8_t const *weights, uint8_t const *in, int32_t *out, size_t rows, size_t stride) {
+            __m256i const ones = _mm256_set1_epi16(1);
+            size_t i = 0;
+
+            for (; i + 4 <= rows; i += 4) {
+                int8_t const *w = weights + i * stride;
+                __m256i acc0 = _mm256_setzero_si256(), acc1 = _mm256_setzero_si256();
+                __m256i acc2 = _mm256_setzero_si256(), acc3 = _mm256_setzero_si256();
+
+                for (size_t j = 0; j < stride; j += 32) {
+                    __m256i x = _mm256_loadu_si256((__m256i const *)(in + j));
+                    acc0 = _mm256_add_epi32(acc0, _mm256_madd_epi16(_mm256_maddubs_epi16(x, _mm256_loadu_si256((__m256i const *)(w + j))), ones));
+                    acc1 = _mm256_add_epi32(acc1, _mm256_madd_epi16(_mm256_maddubs_epi16(x, _mm256_loadu_si256((__m256i const *)(w + stride + j))), ones));
+                    acc2 = _mm256_add_epi32(acc2, _mm256_madd_epi16(_mm256_maddubs_epi16(x, _mm256_loadu_si256((__m256i const *)(w + 2 * stride + j))), ones));
+                    acc3 = _mm256_add_epi32(acc3, _mm256_madd_epi16(_mm256_maddubs_epi16(x, _mm256_loadu_si256((__m256i const *)(w + 3 * stride + j))), ones));
+                }
+
+                out[i] = reduceAVX2(acc0);
+                out[i + 1] = reduceAVX2(acc1);
+                out[i + 2] = reduceAVX2(acc2);
+                out[i + 3] = reduceAVX2(acc3);
+            }
+
+            for (; i < rows; i++) {
+                int8_t const *w = weights + i * stride;
+                __m256i acc = _mm256_setzero_si256();
+
+                for (size_t j = 0; j < stride; j += 32)
+                    acc = _mm256_add_epi32(acc, _mm256_madd_epi16(_mm256_maddubs_epi16(_mm256_loadu_si256((__m256i const *)(in + j)),
+                                                                                       _mm256_loadu_si256((__m256i const *)(w + j))),
+                                                                  ones));
+
+                out[i] = reduceAVX2(acc);
+            }
+        }
+
+        __attribute__((target("avx2,avxvnni")))
+        static void dotInt8VNNI(int8_t const *weights, uint8_t const *in, int32_t *out, size_t rows, size_t stride) {
+            size_t i = 0;
+
+            for (; i + 4 <= rows; i += 4) {
+                int8_t const *w = weights + i * stride;
+                __m256i acc0 = _mm256_setzero_si256(), acc1 = _mm256_setzero_si256();
+                __m256i acc2 = _mm256_setzero_si256(), acc3 = _mm256_setzero_si256();
+
+                for (size_t j = 0; j < stride; j += 32) {
+                    __m256i x = _mm256_loadu_si256((__m256i const *)(in + j));
+                    acc0 = _mm256_dpbusd_avx_epi32(acc0, x, _mm256_loadu_si256((__m256i const *)(w + j)));
+                    acc1 = _mm256_dpbusd_avx_epi32(acc1, x, _mm256_loadu_si256((__m256i const *)(w + stride + j)));
+                    acc2 = _mm256_dpbusd_avx_epi32(acc2, x, _mm256_loadu_si256((__m256i const *)(w + 2 * stride + j)));
+                    acc3 = _mm256_dpbusd_avx_epi32(acc3, x, _mm256_loadu_si256((__m256i const *)(w + 3 * stride + j)));
+                }
+
+                out[i] = reduceAVX2(acc0);
+                out[i + 1] = reduceAVX2(acc1);
+                out[i + 2] = reduceAVX2(acc2);
+                out[i + 3] = reduceAVX2(acc3);
+            }
+
+            for (; i < rows; i++) {
+                int8_t const *w = weights + i * stride;
+                __m256i acc = _mm256_setzero_si256();
+
+                for (size_t j = 0; j < stride; j += 32)
+                    acc = _mm256_dpbusd_avx_epi32(acc, _mm256_loadu_si256((__m256i const *)(in + j)), _mm256_loadu_si256((__m256i const *)(w + j)));
+
+                out[i] = reduceAVX2(acc);
+            }
+        }
+
+#endif
+
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /////                                   Dispatch                                         /////
+        //////////////////////////////////////////////////////////////////////////////////////////////
+
+        struct KernelTable {
+            isa_t isa;
+            void (*dense)(double const *, double const *, double const *, double *, size_t, size_t);
+            void (*multiplyAdd)(double *, double const *, double const *, size_t);
+            void (*densef)(float const *, float const *, float const *, float *, size_t, size_t);
+            void (*multiplyAddf)(float *, float const *, float const *, size_t);
+            void (*dotInt8)(int8_t const *, uint8_t const *, int32_t *, size_t, size_t);
+            char const *int8;
+        };
+
+        static bool vnni() {
+#ifdef NEURAL_KERNELS_X86
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avxvnni");
+#else
+            return false;
+#endif
+        }
+
+        static KernelTable tableFor(isa_t val) {
+            switch (val) {
+#ifdef NEURAL_KERNELS_X86
+            case isa_t::AVX512:
+                return {isa_t::AVX512, denseAVX512, multiplyAddAVX512, denseAVX512, multiplyAddAVX512,
+                        vnni() ? dotInt8VNNI : dotInt8AVX2, vnni() ? "AVX-VNNI" : "AVX2"};
+            case isa_t::AVX2:
+                return {isa_t::AVX2, denseAVX2, multiplyAddAVX2, denseAVX2, multiplyAddAVX2,
+                        vnni() ? dotInt8VNNI : dotInt8AVX2, vnni() ? "AVX-VNNI" : "AVX2"};
+            case isa_t::SSE2:
+                return {isa_t::SSE2, denseSSE2, multiplyAddSSE2, denseSSE2, multiplyAddSSE2, dotInt8Scalar, "Scalar"};
+#endif
+            default:
+                return {isa_t::Scalar, denseScalar<double>, multiplyAddScalar<double>, denseScalar<float>, multiplyAddScalar<float>,
+                        dotInt8Scalar, "Scalar"};
+            }
+        }
+
+        isa_t detect() {
+#ifdef NEURAL_KERNELS_X86
+            __builtin_cpu_init();
+
+            if (__builtin_cpu_supports("avx512f"))
+                return isa_t::AVX512;
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+                return isa_t::AVX2;
+            if (__builtin_cpu_supports("sse2"))
+                return isa_t::SSE2;
+#endif
+            return isa_t::Scalar;
+        }
+
+        // une table constante par jeu d'instructions, construite une fois : isa(val) ne fait que changer de pointeur,
+        // les threads qui calculent au même moment voient l'ancienne table ou la nouvelle, jamais un mélange
+        static KernelTable const &tableOf(isa_t val) {
+            static KernelTable const tables[] = {tableFor(isa_t::Scalar), tableFor(isa_t::SSE2), tableFor(isa_t::AVX2), tableFor(isa_t::AVX512)};
+            return tables[static_cast<int>(val)];
+        }
+
+        static std::atomic<KernelTable const *> &current() {
+            static std::atomic<KernelTable const *> table(&tableOf(detect()));
+            return table;
+        }
+
+        static KernelTable const &table() {
+            return *current().load(std::memory_order_acquire);
+        }
+
+        isa_t isa() {
+            return table().isa;
+        }
+
+        void isa(isa_t val) {
+            isa_t best = detect();
+
+            if (static_cast<int>(val) > static_cast<int>(best))
+                val = best;
+
+            current().store(&tableOf(val), std::memory_order_release);
+        }
+
+        char const *isaToString(isa_t val) {
+            switch (val) {
+            case isa_t::SSE2:
+                return "SSE2";
+            case isa_t::AVX2:
+                return "AVX2";
+            case isa_t::AVX512:
+                return "AVX-512";
+            default:
+                return "Scalar";
+            }
+        }
+
+        void dense(double const *weights, double const *bias, double const *in, double *out, size_t rows, size_t cols) {
+            table().dense(weights, bias, in, out, rows, cols);
+        }
+
+        void multiplyAdd(double *acc, double const *a, double const *b, size_t n) {
+            table().multiplyAdd(acc, a, b, n);
+        }
+
+        void dense(float const *weights, float const *bias, float const *in, float *out, size_t rows, size_t cols) {
+            table().densef(weights, bias, in, out, rows, cols);
+        }
+
+        void multiplyAdd(float *acc, float const *a, float const *b, size_t n) {
+            table().multiplyAddf(acc, a, b, n);
+        }
+
+        void dotInt8(int8_t const *weights, uint8_t const *in, int32_t *out, size_t rows, size_t stride) {
+            table().dotInt8(weights, in, out, rows, stride);
+        }
+
+        char const *int8Kernel() {
+            return table().int8;
+        }
+
+    } // namespace kernels
+
+} // namespace neuralnetwork
@@ -0,0 +1,74 @@
+#include "neural_network/mutation.hpp"
+#include "neural_network/genome_hash.hpp"
+
+#include <cmath>
+
+namespace neuralnetwork
+{
+
+    namespace mutation
+    {
+
+        template <typename Scalar>
+        void gaussian(util::Span<Scalar> params, double rate, double sigma, util::Random &rng, uint64_t *hash) {
+            size_t const n = params.size();
+
+            if (!(rate > 0) || n == 0)
+                return;
+
+            static size_t const BLOCK = 64;
+            size_t indices[BLOCK];
+            double noise[BLOCK];
+
+            // rate >= 1 : tous les paramètres, sinon saut = floor(log(u) / log(1 - rate)), u dans ]0, 1]
+            bool const all = rate >= 1;
+            double const scale = all ? 0 : 1. / std::log1p(-rate);
+
+            size_t i = 0;
+
+            while (true) {
+                size_t count = 0;
+
+                while (count < BLOCK) {
+                    if (!all) {
+                        double gap = std::floor(std::log(rng.uniformPositive()) * scale);
+                        if (gap >= (double)(n - i))
+                            break;
+                        i += (size_t)gap;
+                    }
+
+                    if (i >= n)
+                        break;
+
+                    indices[count++] = i++;
+                }
+
+                rng.normal(noise, count, 0, sigma);
+
+                if (hash == nullptr) {
+                    for (size_t k = 0; k < count; k++)
+                        params[indices[k]] += noise[k];
+                } else {
+                    uint64_t delta = 0;
+
+                    for (size_t k = 0; k < count; k++) {
+                        Scalar &p = params[indices[k]];
+                        delta -= hashing::element(indices[k], p);
+                        p += noise[k];
+                        delta += hashing::element(indices[k], p);
+                    }
+
+                    *hash += delta;
+                }
+
+                if (count < BLOCK)
+                    return;
+            }
+        }
+
+        template void gaussian<float>(util::Span<float>, double, double, util::Random &, uint64_t *);
+        template void gaussian<double>(util::Span<double>, double, double, util::Random &, uint64_t *);
+
+    } // namespace mutation
+
+} // namespace neuralnetwork
@@ -0,0 +1,503 @@
+#include "neural_network/neat.hpp"
+#include "neural_network/genome_hash.hpp"
+#include "neural_network/mutation.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace neuralnetwork
+{
+
+    namespace neat
+    {
+        Config::Config(NeuralParameters const &params)
+            : ninput(params.ninput), noutput(params.noutput),
+              input_activation(params.input_activation), hidden_activation(params.hidden_activation), output_activation(params.output_activation),
+              add_node_rate(params.add_node_rate), add_connection_rate(params.add_connection_rate) {
+            if (ninput == 0 || noutput == 0)
+                throw std::invalid_argument("NeatNetwork : il faut au moins une entree et une sortie");
+        }
+
+        // parcours commun des deux listes triées par innovation, entry(i) donne (innovation, poids)
+        template <typename First, typename Second>
+        static double compatibility(size_t nfirst, First first, size_t nsecond, Second second, double disjoint, double weight, double limit) {
+            double const n = std::max<size_t>(std::max(nfirst, nsecond), 1);
+
+            size_t i = 0, j = 0;
+            size_t unmatched = 0, matched = 0;
+            double difference = 0;
+
+            while (i < nfirst && j < nsecond) {
+                auto a = first(i);
+                auto b = second(j);
+
+                if (a.first == b.first) {
+                    difference += std::fabs((double)a.second - (double)b.second);
+                    matched++;
+                    i++;
+                    j++;
+                } else {
+                    unmatched++;
+                    (a.first < b.first ? i : j)++;
+
+                    // le terme des gènes non appariés ne peut que croître
+                    if (disjoint * unmatched / n > limit)
+                        return disjoint * unmatched / n;
+                }
+            }
+
+            unmatched += (nfirst - i) + (nsecond - j);
+            return disjoint * unmatched / n + weight * (matched == 0 ? 0 : difference / matched);
+        }
+    } // namespace neat
+
+    //////////////////////////////////////////////////////////////////////////////////////////////////
+    /////                                    NeatNetwork                                         /////
+    //////////////////////////////////////////////////////////////////////////////////////////////////
+
+    template <typename Scalar>
+    BasicNeatNetwork<Scalar>::BasicNeatNetwork(NeuralParameters const &params) {
+        util::Random rng(util::threadRandom()());
+        *this = BasicNeatNetwork(params, rng);
+    }
+
+    template <typename Scalar>
+    BasicNeatNetwork<Scalar>::BasicNeatNetwork(NeuralParameters const &params, util::Random &rng)
+        : m_config(std::make_shared<neat::Config const>(params)), m_compiled(false), m_planned(0), m_bound(0), m_output(0), m_score(-1), m_fitness(-1) {
+        size_t const ni = m_config->ninput, no = m_config->noutput;
+
+        // topologie minimale : chaque entrée reliée à chaque sortie
+        for (size_t i = 0; i < ni; i++)
+            m_nodes.push_back({i, m_config->input_activation});
+        for (size_t o = 0; o < no; o++)
+            m_nodes.push_back({ni + o, m_config->output_activation});
+
+        for (size_t i = 0; i < ni; i++)
+            for (size_t o = 0; o < no; o++)
+                m_connections.push_back({neat::innovation(i, ni + o), i, ni + o, true});
+
+        std::sort(m_connections.begin(), m_connections.end(),
+                  [](neat::ConnectionGene const &a, neat::ConnectionGene const &b) { return a.innovation < b.innovation; });
+
+        // même loi que BasicNeuralNetwork : biais puis poids, uniformes dans [0, 2[
+        m_params.resize(m_connections.size() + no);
+
+        Scalar *bias = m_params.data() + m_connections.size();
+        rng.uniform(bias, no);
+        rng.uniform(m_params.data(), m_connections.size());
+
+        for (Scalar &v : m_params)
+            v *= 2;
+
+        rehash();
+    }
+
+    template <typename Scalar>
+    size_t BasicNeatNetwork<Scalar>::index(uint64_t id) const {
+        auto it = std::lower_bound(m_nodes.begin(), m_nodes.end(), id, [](neat::NodeGene const &node, uint64_t id) { return node.id < id; });
+        return it != m_nodes.end() && it->id == id ? it - m_nodes.begin() : m_nodes.size();
+    }
+
+    template <typename Scalar>
+    size_t BasicNeatNetwork<Scalar>::connection(uint64_t innovation) const {
+        auto it = std::lower_bound(m_connections.begin(), m_connections.end(), innovation,
+                                   [](neat::ConnectionGene const &c, uint64_t innovation) { return c.innovation < innovation; });
+        return it != m_connections.end() && it->innovation == innovation ? it - m_connections.begin() : m_connections.size();
+    }
+
+    template <typename Scalar>
+    void BasicNeatNetwork<Scalar>::adjacency(std::vector<uint32_t> &first, std::vector<uint32_t> &targets) const {
+        size_t const n = m_nodes.size();
+        std::vector<uint32_t> source(m_connections.size());
+
+        // les connexions désactivées comptent : un croisement peut les réactiver
+        first.assign(n + 1, 0);
+        for (size_t c = 0; c < m_connections.size(); c++) {
+            source[c] = index(m_connections[c].in);
+            first[source[c] + 1]++;
+        }
+
+        for (size_t i = 0; i < n; i++)
+            first[i + 1] += first[i];
+
+        targets.resize(first[n]);
+        std::vector<uint32_t> cursor(first.begin(), first.end() - 1);
+
+        for (size_t c = 0; c < m_connections.size(); c++)
+            targets[cursor[source[c]]++] = index(m_connections[c].out);
+    }
+
+    template <typename Scalar>
+    bool BasicNeatNetwork<Scalar>::reaches(std::vector<uint32_t> const &first, std::vector<uint32_t> const &targets, size_t from, size_t to) {
+        std::vector<uint32_t> stack = {(uint32_t)from};
+        std::vector<bool> visited(first.size() - 1, false);
+        visited[from] = true;
+
+        while (!stack.empty()) {
+            uint32_t node = stack.back();
+            stack.pop_back();
+
+            if (node == to)
+                return true;
+
+            for (uint32_t e = first[node]; e < first[node + 1]; e++) {
+                if (!visited[targets[e]]) {
+                    visited[targets[e]] = true;
+                    stack.push_back(targets[e]);
+                }
+            }
+        }
+        return false;
+    }
+
+    template <typename Scalar>
+    void BasicNeatNetwork<Scalar>::insertConnection(uint64_t in, uint64_t out, Scalar weight) {
+        uint64_t innovation = neat::innovation(in, out);
+
+        auto it = std::lower_bound(m_connections.begin(), m_connections.end(), innovation,
+                                   [](neat::ConnectionGene const &c, uint64_t innovation) { return c.innovation < innovation; });
+        size_t pos = it - m_connections.begin();
+
+        m_connections.insert(it, {innovation, in, out, true});
+        m_params.insert(m_params.begin() + pos, weight);
+    }
+
+    template <typename Scalar>
+    bool BasicNeatNetwork<Scalar>::addConnection(util::Random &rng) {
+        size_t const ni = m_config->ninput, no = m_config->noutput;
+        size_t const n = m_nodes.size();
+
+        // graphe construit une fois pour tous les essais, il ne change qu'à l'insertion
+        std::vector<uint32_t> first, targets;
+        adjacency(first, targets);
+
+        // quelques essais au hasard, abandon si le graphe est presque complet
+        for (int attempt = 0; attempt < 20; attempt++) {
+            size_t from = std::min<size_t>(rng.uniform() * n, n - 1);
+            size_t to = ni + std::min<size_t>(rng.uniform() * (n - ni), n - ni - 1);
+
+            if (from == to || (from >= ni && from < ni + no))
+                continue; // une sortie n'alimente rien
+
+            if (connection(neat::innovation(m_nodes[from].id, m_nodes[to].id)) != m_connections.size())
+                continue;
+
+            if (reaches(first, targets, to, from))
+                continue; // cycle
+
+            insertConnection(m_nodes[from].id, m_nodes[to].id, rng.uniform() * 2);
+            return true;
+        }
+        return false;
+    }
+
+    template <typename Scalar>
+    bool BasicNeatNetwork<Scalar>::addNode(util::Random &rng) {
+        size_t enabled = 0;
+        for (neat::ConnectionGene const &c : m_connections)
+            enabled += c.enabled;
+
+        if (enabled == 0)
+            return false;
+
+        // k-ième connexion active
+        size_t k = std::min<size_t>(rng.uniform() * enabled, enabled - 1);
+        size_t split = 0;
+        for (;; split++)
+            if (m_connections[split].enabled && k-- == 0)
+                break;
+
+        neat::ConnectionGene const old = m_connections[split];
+        Scalar const weight = m_params[split];
+
+        // la même coupure refaite plus tard (après réactivation) crée un autre noeud
+        unsigned version = 0;
+        while (index(neat::splitNode(old.innovation, version)) != m_nodes.size())
+            version++;
+        uint64_t id = neat::splitNode(old.innovation, version);
+
+        m_connections[split].enabled = false;
+
+        auto it = std::lower_bound(m_nodes.begin(), m_nodes.end(), id, [](neat::NodeGene const &node, uint64_t id) { return node.id < id; });
+        size_t pos = it - m_nodes.begin();
+
+        m_nodes.insert(it, {id, m_config->hidden_activation});
+        m_params.insert(m_params.begin() + m_connections.size() + (pos - m_config->ninput), Scalar(0));
+
+        // in -> nouveau (poids 1) -> out (ancien poids) : le réseau calcule presque la même chose
+        insertConnection(old.in, id, 1);
+        insertConnection(id, old.out, weight);
+        return true;
+    }
+
+    template <typename Scalar>
+    void BasicNeatNetwork<Scalar>::hashStructure() {
+        m_structure = 0;
+
+        for (neat::ConnectionGene const &c : m_connections)
+            m_structure += util::mix64(c.innovation ^ (c.enabled ? 0 : 0x8000000000000000ull));
+        for (neat::NodeGene const &node : m_nodes)
+            m_structure += util::mix64(node.id * 0x9E3779B97F4A7C15ull ^ static_cast<unsigned>(node.activation));
+    }
+
+    template <typename Scalar>
+    void BasicNeatNetwork<Scalar>::rehash() {
+        hashStructure();
+        m_hash = m_structure + hashing::genome<Scalar>(params());
+    }
+
+    template <typename Scalar>
+    void BasicNeatNetwork<Scalar>::prepare() {
+        if (!m_compiled || m_planned != m_structure) {
+            m_plan.compile(*this);
+            m_compiled = true;
+            m_planned = m_structure;
+            m_bound = m_hash;
+        } else if (m_bound != m_hash) {
+            m_plan.bind(params());
+            m_bound = m_hash;
+        }
+    }
+
+    template <typename Scalar>
+    size_t BasicNeatNetwork<Scalar>::compute(util::Span<Scalar const> inputs) {
+        if (inputs.size() < m_config->ninput)
+            throw std::invalid_argument("NeatNetwork : pas assez d'entrees");
+
+        prepare();
+        m_output = m_plan.run(inputs.data());
+        return m_output;
+    }
+
+    template <typename Scalar>
+    size_t BasicNeatNetwork<Scalar>::compute(util::Span<Scalar const> inputs, util::Span<Scalar> outputs) {
+        if (inputs.size() < m_config->ninput)
+            throw std::invalid_argument("NeatNetwork : pas assez d'entrees");
+        if (outputs.size() < m_config->noutput)
+            throw std::invalid_argument("NeatNetwork : buffer de sortie trop petit");
+
+        prepare();
+        m_output = m_plan.run(inputs.data(), outputs.data());
+        return m_output;
+    }
+
+    template <typename Scalar>
+    void BasicNeatNetwork<Scalar>::crossover(BasicNeatNetwork const &first, BasicNeatNetwork const &second, crossover_t,
+                                             double const, util::Random &rng) {
+        BasicNeatNetwork const &fitter = second.score() > first.score() ? second : first;
+        BasicNeatNetwork const &other = &fitter == &first ? second : first;
+
+        // les gènes de l'enfant sont ceux du meilleur parent, seuls poids, biais et activations changent
+        m_config = fitter.m_config;
+        m_nodes = fitter.m_nodes;
+        m_connections = fitter.m_connections;
+        m_params = fitter.m_params;
+
+        if (&first == &second) {
+            m_structure = fitter.m_structure;
+            m_hash = fitter.m_hash;
+            return;
+        }
+
+        size_t j = 0;
+        for (size_t i = 0; i < m_connections.size(); i++) {
+            uint64_t innovation = m_connections[i].innovation;
+
+            while (j < other.m_connections.size() && other.m_connections[j].innovation < innovation)
+                j++;
+
+            if (j == other.m_connections.size() || other.m_connections[j].innovation != innovation)
+                continue;
+
+            if (rng.uniform() < 0.5)
+                m_params[i] = other.m_params[j];
+
+            if (!m_connections[i].enabled || !other.m_connections[j].enabled)
+                m_connections[i].enabled = !(rng.uniform() < 0.75);
+        }
+
+        // biais des noeuds présents chez les deux parents
+        size_t const ni = m_config->ninput;
+        size_t const ncon = m_connections.size(), other_ncon = other.m_connections.size();
+
+        j = ni;
+        for (size_t i = ni; i < m_nodes.size(); i++) {
+            while (j < other.m_nodes.size() && other.m_nodes[j].id < m_nodes[i].id)
+                j++;
+
+            if (j < other.m_nodes.size() && other.m_nodes[j].id == m_nodes[i].id && rng.uniform() < 0.5)
+                m_params[ncon + i - ni] = other.m_params[other_ncon + j - ni];
+        }
+
+        rehash();
+    }
+
+    template <typename Scalar>
+    void BasicNeatNetwork<Scalar>::mutate(double const mutation_rate) {
+        util::Random rng(util::threadRandom()());
+        mutate(mutation_rate, rng);
+    }
+
+    template <typename Scalar>
+    void BasicNeatNetwork<Scalar>::mutate(double const mutation_rate, util::Random &rng, double const sigma) {
+        mutation::gaussian(params(), mutation_rate, sigma, rng, &m_hash);
+
+        bool structural = false;
+
+        if (rng.uniform() < m_config->add_connection_rate)
+            structural |= addConnection(rng);
+        if (rng.uniform() < m_config->add_node_rate)
+            structural |= addNode(rng);
+
+        // les insertions décalent les indices des paramètres : empreinte recalculée
+        if (structural)
+            rehash();
+    }
+
+    template <typename Scalar>
+    double BasicNeatNetwork<Scalar>::distance(BasicNeatNetwork const &first, BasicNeatNetwork const &second, double disjoint,
+                                              double weight, double limit) {
+        auto gene = [](BasicNeatNetwork const &network) {
+            return [&network](size_t i) { return std::make_pair(network.m_connections[i].innovation, network.m_params[i]); };
+        };
+
+        return neat::compatibility(first.m_connections.size(), gene(first), second.m_connections.size(), gene(second), disjoint, weight, limit);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////////
+    /////                                     Speciation                                         /////
+    //////////////////////////////////////////////////////////////////////////////////////////////////
+
+    template <typename Scalar>
+    BasicSpeciation<Scalar>::BasicSpeciation(NeuralParameters const &params)
+        : m_disjoint(params.compatibility_disjoint), m_weight(params.compatibility_weight), m_threshold(params.compatibility_threshold),
+          m_next_id(0), m_comparisons(0) {}
+
+    template <typename Scalar>
+    double BasicSpeciation<Scalar>::distance(BasicNeatNetwork<Scalar> const &genome, Species const &species) const {
+        std::vector<neat::ConnectionGene> const &connections = genome.connections();
+
+        return neat::compatibility(
+            connections.size(), [&](size_t i) { return std::make_pair(connections[i].innovation, genome.weight(i)); },
+            species.innovations.size(), [&](size_t i) { return std::make_pair(species.innovations[i], species.weights[i]); },
+            m_disjoint, m_weight, m_threshold);
+    }
+
+    template <typename Scalar>
+    void BasicSpeciation<Scalar>::represent(Species &species, BasicNeatNetwork<Scalar> const &genome) {
+        std::vector<neat::ConnectionGene> const &connections = genome.connections();
+
+        species.innovations.resize(connections.size());
+        species.weights.resize(connections.size());
+
+        for (size_t c = 0; c < connections.size(); c++) {
+            species.innovations[c] = connections[c].innovation;
+            species.weights[c] = genome.weight(c);
+        }
+    }
+
+    template <typename Scalar>
+    void BasicSpeciation<Scalar>::assign(util::Span<BasicNeatNetwork<Scalar> const *const> genomes, util::Span<double const> scores,
+                                         util::Span<double> shared) {
+        static uint32_t const none = UINT32_MAX;
+
+        size_t const n = genomes.size();
+
+        m_known.clear();
+        m_assignment.resize(n);
+        m_comparisons = 0;
+
+        for (Species &species : m_species) {
+            species.size = 0;
+            species.best = -std::numeric_limits<double>::infinity();
+        }
+
+        std::vector<size_t> first_member(m_species.size(), n);
+        uint32_t last = none;
+
+        for (size_t i = 0; i < n; i++) {
+            BasicNeatNetwork<Scalar> const &genome = *genomes[i];
+            uint32_t found = none;
+
+            auto known = m_known.find(genome.hash());
+
+            if (known != m_known.end()) {
+                found = known->second;
+            } else {
+                // espèce du génome précédent d'abord : les enfants d'une même lignée se suivent souvent
+                if (last != none) {
+                    m_comparisons++;
+                    if (distance(genome, m_species[last]) < m_threshold)
+                        found = last;
+                }
+
+                for (uint32_t s = 0; s < m_species.size() && found == none; s++) {
+                    if (s == last)
+                        continue;
+
+                    m_comparisons++;
+                    if (distance(genome, m_species[s]) < m_threshold)
+                        found = s;
+                }
+
+                if (found == none) {
+                    Species species;
+                    species.id = m_next_id++;
+                    species.size = 0;
+                    species.best = -std::numeric_limits<double>::infinity();
+                    species.age = 0;
+                    represent(species, genome);
+
+                    m_species.push_back(std::move(species));
+                    first_member.push_back(n);
+                    found = m_species.size() - 1;
+                }
+
+                m_known.emplace(genome.hash(), found);
+            }
+
+            m_assignment[i] = found;
+            m_species[found].size++;
+            m_species[found].best = std::max(m_species[found].best, scores[i]);
+
+            if (first_member[found] == n)
+                first_member[found] = i;
+
+            last = found;
+        }
+
+        for (size_t i = 0; i < n; i++)
+            shared[i] = scores[i] / m_species[m_assignment[i]].size;
+
+        // espèces vides supprimées, le représentant suivant est le premier membre de cette génération
+        std::vector<uint32_t> remap(m_species.size(), none);
+        size_t kept = 0;
+
+        for (size_t s = 0; s < m_species.size(); s++) {
+            if (m_species[s].size == 0)
+                continue;
+
+            Species &species = m_species[s];
+
+            represent(species, *genomes[first_member[s]]);
+            species.age++;
+
+            remap[s] = kept;
+            if (kept != s)
+                m_species[kept] = std::move(m_species[s]);
+            kept++;
+        }
+
+        m_species.resize(kept);
+
+        for (uint32_t &s : m_assignment)
+            s = remap[s];
+    }
+
+    template class BasicNeatNetwork<float>;
+    template class BasicNeatNetwork<double>;
+    template class BasicSpeciation<float>;
+    template class BasicSpeciation<double>;
+
+} // namespace neuralnetwork
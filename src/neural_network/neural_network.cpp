@@ -1,375 +1,368 @@
 #include "neural_network/neural_network.hpp"
+#include "neural_network/genome_hash.hpp"
+#include "neural_network/kernels.hpp"
+#include "neural_network/mutation.hpp"
 
+#include <algorithm>
 #include <cmath>
 
 namespace neuralnetwork
 {   
 
-    //
-    double sigmoid(double x) {
-        return 1 / (1 + exp(-(x)) ); //default sigmoid
-    }
-
     //
     double rand_gen() {
         // return a uniformly distributed random value
-        return ( (double)(rand()) + 1. )/( (double)(RAND_MAX) + 1. );
+        return util::threadRandom().uniformPositive();
     }
 
     //
     double normalRandom() {
         // return a normally distributed random value
-        double v1=rand_gen();
-        double v2=rand_gen();
-        return cos(2*3.14*v2)*sqrt(-2.*log(v1));
+        return util::threadRandom().normal();
     }
 
     //////////////////////////////////////////////////////////////////////////////////////////////////
-    /////                                        LAYER                                           /////
+    /////                                      Topology                                          /////
     //////////////////////////////////////////////////////////////////////////////////////////////////
 
-    Layer::Layer(int neurons, Layer* previous_layer){
+    Topology::Topology(NeuralParameters const &params) : nparams(0), nneurons(0) {
+        sizes.push_back(params.ninput);
+        activations.push_back(params.input_activation);
 
-        m_neurons.resize(neurons, 0);
+        for (unsigned i = 0; i < params.nhiddenlayer; i++) {
+            sizes.push_back(params.nhidden);
+            activations.push_back(params.hidden_activation);
+        }
 
-        if(previous_layer != nullptr){
-            m_bias.resize(neurons, 0);
-            m_weights.resize(neurons * previous_layer->size(), 0);
-            initWeigth(previous_layer->size());
+        sizes.push_back(params.noutput);
+        activations.push_back(params.output_activation);
+
+        for (size_t l = 0; l < sizes.size(); l++) {
+            param_offsets.push_back(nparams);
+            neuron_offsets.push_back(nneurons);
+
+            nparams += nweights(l) + nbias(l);
+            nneurons += sizes[l];
         }
-            
     }
 
-    Layer::Layer(Layer const &other) {
-        *this = other;
+    bool Topology::operator==(Topology const &other) const {
+        return sizes == other.sizes && activations == other.activations;
     }
 
-    Layer::Layer(Layer&& other) {
-        *this = std::move(other);
-    }
+    //////////////////////////////////////////////////////////////////////////////////////////////////
+    /////                                        LAYER                                           /////
+    //////////////////////////////////////////////////////////////////////////////////////////////////
 
-    Layer &Layer::operator=(Layer const &other) {
-        m_neurons = other.m_neurons;
-        m_bias = other.m_bias;
-        m_weights = other.m_weights;
-        return *this;
+    template <typename Scalar>
+    BasicLayer<Scalar>::BasicLayer(Scalar *neurons, Scalar *params, size_t size, size_t inputs, activation_t activation)
+        : m_neurons(neurons),
+          m_weights(params),
+          m_bias(params == nullptr ? nullptr : params + size * inputs),
+          m_size(size),
+          m_inputs(inputs),
+          m_activation(activation) {}
+
+    template <typename Scalar>
+    void BasicLayer<Scalar>::initWeigth(){
+        util::Random rng(util::threadRandom()());
+        initWeigth(rng);
     }
 
-    Layer &Layer::operator=(Layer &&other) {
-        m_neurons = std::move(other.m_neurons);
-        m_bias = std::move(other.m_bias);
-        m_weights = std::move(other.m_weights);
-        return *this;
+    template <typename Scalar>
+    void BasicLayer<Scalar>::initWeigth(util::Random &rng){
+        // tirages uniformes dans [0, 2[, en bloc
+        rng.uniform(m_bias, size());
+        for (size_t i = 0; i < size() ; i++)
+            m_bias[i] *= 2;
+
+        rng.uniform(m_weights, m_inputs * m_size);
+        for (size_t i = 0; i < m_inputs * m_size; i++ )
+            m_weights[i] *= 2;
     }
 
-    void Layer::initWeigth( int previousLayerSize ){
-        for (size_t i = 0; i < size() ; i++) 
-            m_bias[i] = ((double)rand() / (double)RAND_MAX) * 2 ;
-        
 
-        for (size_t i = 0; i < previousLayerSize * m_neurons.size(); i++ )
-            m_weights[i]= (rand() / RAND_MAX)*2 ;
-        
-    }
+    template <typename Scalar>
+    void BasicLayer<Scalar>::compute( BasicLayer const& previous ){
+        // produit matrice-vecteur vectorisé, voir kernels.cpp
+        kernels::dense(m_weights, m_bias, previous.data(), m_neurons, size(), previous.size());
 
+        activate(m_activation, m_neurons, size());
+    }
 
-    void Layer::compute( Layer const& previous ){
-        double s = 0;
-        
-        size_t tmp = previous.size();
 
-        for (size_t i = 0; i < size() ; i++){
-            s = m_bias[i];
-            for(size_t j = 0; j < tmp; j++){
-                s += m_weights[i * tmp + j] * previous[j]; // stocker ou appeller à chaque fois ?
-            }
-            m_neurons[i] = sigmoid(s);
-        }
+    template <typename Scalar>
+    void BasicLayer<Scalar>::computeLinear( BasicLayer const& previous ){
+        kernels::dense(m_weights, m_bias, previous.data(), m_neurons, size(), previous.size());
     }
 
 
-    void Layer::compute( std::vector<double> const& inputs ){
+    template <typename Scalar>
+    void BasicLayer<Scalar>::compute( Scalar const* inputs ){
 
         for (size_t i = 0; i < size() ; i++) 
-            m_neurons[i] = sigmoid(inputs[i]);
+            m_neurons[i] = inputs[i];
+
+        activate(m_activation, m_neurons, size());
         
     }
 
 
-    void Layer::mutate(double const mutation_rate) {
-        for (auto& i : m_bias) 
-            if( mutation_rate > (double) rand() / (double) RAND_MAX) { i += normalRandom() * 0.05;}
-            
-        for (auto& i : m_weights)
-            if( mutation_rate > (double) rand() / (double) RAND_MAX) { i += normalRandom() * 0.05;}
-        
+    template <typename Scalar>
+    void BasicLayer<Scalar>::mutate(double const mutation_rate) {
+        util::Random rng(util::threadRandom()());
+        mutate(mutation_rate, rng);
+    }
+
+    template <typename Scalar>
+    void BasicLayer<Scalar>::mutate(double const mutation_rate, util::Random &rng, double const sigma) {
+        mutation::gaussian(bias(), mutation_rate, sigma, rng);
+        mutation::gaussian(weights(), mutation_rate, sigma, rng);
     }
 
     //////////////////////////////////////////////////////////////////////////////////////////////////
     /////                                   NeuralNetwork                                        /////
     //////////////////////////////////////////////////////////////////////////////////////////////////
 
-    NeuralNetwork::NeuralNetwork(NeuralParameters const& params) : m_score(-1), m_fitness(-1) {
-        
-        
-        m_size = 2 + params.nhiddenlayer;
-        m_layers.reserve(m_size);
+    template <typename Scalar>
+    BasicNeuralNetwork<Scalar>::BasicNeuralNetwork(NeuralParameters const& params)
+        : BasicNeuralNetwork(std::make_shared<Topology const>(params)) {
 
+        for(size_t i = 1; i < size(); i++)
+            (*this)[i].initWeigth();
 
-        m_layers.emplace_back(params.ninput);
-        
-        for(int i = 0; i < params.nhiddenlayer; i++){
-            m_layers.emplace_back(params.nhidden, &m_layers.back());
-        }
-        
-        m_layers.emplace_back(params.noutput, &m_layers.back()); //input
+        rehash();
+    }
+
+    template <typename Scalar>
+    BasicNeuralNetwork<Scalar>::BasicNeuralNetwork(NeuralParameters const& params, util::Random &rng)
+        : BasicNeuralNetwork(std::make_shared<Topology const>(params)) {
+
+        for(size_t i = 1; i < size(); i++)
+            (*this)[i].initWeigth(rng);
+
+        rehash();
+    }
+
+    template <typename Scalar>
+    BasicNeuralNetwork<Scalar>::BasicNeuralNetwork(std::shared_ptr<Topology const> topology)
+        : m_topology(std::move(topology)), m_score(-1), m_fitness(-1) {
+
+        // deux allocations par réseau, quelle que soit la profondeur
+        m_params.resize(m_topology->nparams, 0);
+        m_neurons.resize(m_topology->nneurons, 0);
 
+        rehash();
     }
 
-    NeuralNetwork::NeuralNetwork(NeuralNetwork const &other) {
+    template <typename Scalar>
+    BasicNeuralNetwork<Scalar>::BasicNeuralNetwork(BasicNeuralNetwork const &shape, util::Span<Scalar const> params)
+        : m_topology(shape.m_topology), m_score(-1), m_fitness(-1) {
+        if (params.size() != m_topology->nparams)
+            throw std::invalid_argument("NeuralNetwork : nombre de parametres different de la topologie");
+
+        m_params.assign(params.begin(), params.end());
+        m_neurons.resize(m_topology->nneurons, 0);
+
+        rehash();
+    }
+
+    template <typename Scalar>
+    BasicNeuralNetwork<Scalar>::BasicNeuralNetwork(BasicNeuralNetwork const &other) {
         *this = other;
     }
 
-    NeuralNetwork::NeuralNetwork(NeuralNetwork&& other) {
+    template <typename Scalar>
+    BasicNeuralNetwork<Scalar>::BasicNeuralNetwork(BasicNeuralNetwork&& other) {
         *this = std::move(other);
     }
 
-    NeuralNetwork &NeuralNetwork::operator=(NeuralNetwork const &other) {
-        m_layers = other.m_layers;
+    template <typename Scalar>
+    BasicNeuralNetwork<Scalar> &BasicNeuralNetwork<Scalar>::operator=(BasicNeuralNetwork const &other) {
+        // même taille : pas de réallocation, simple copie des buffers
+        m_topology = other.m_topology;
+        m_params = other.m_params;
+        m_neurons.resize(other.m_neurons.size());
         m_score = other.m_score;
+        m_hash = other.m_hash;
         m_fitness = other.m_fitness;
-        m_size = other.m_size;
         return *this;
     }
 
-    NeuralNetwork &NeuralNetwork::operator=(NeuralNetwork &&other) {
-        m_layers = std::move(other.m_layers);
+    template <typename Scalar>
+    BasicNeuralNetwork<Scalar> &BasicNeuralNetwork<Scalar>::operator=(BasicNeuralNetwork &&other) {
+        m_topology = std::move(other.m_topology);
+        m_params = std::move(other.m_params);
+        m_neurons = std::move(other.m_neurons);
         m_score = other.m_score;
+        m_hash = other.m_hash;
         m_fitness = other.m_fitness;
-        m_size = other.m_size;
 
-        other.m_size = 0;
         other.m_score = 0;
         other.m_fitness = 0;
         return *this;
     }
 
-    size_t NeuralNetwork::compute(std::vector<double> const& inputs){
-
-        m_layers.front().compute(inputs);
-
-        for(int i = 1; i < m_size; i++)
-            m_layers[i].compute(m_layers[i - 1]);
-        return output();
-    } 
-
-    size_t NeuralNetwork::output() const {
-
-        
-        auto& tmp = m_layers.back();
-        
-        double max = tmp[0];
-        size_t index = 0;
+    template <typename Scalar>
+    typename BasicNeuralNetwork<Scalar>::layer_type BasicNeuralNetwork<Scalar>::operator[](size_t index) {
+        Topology const &topology = *m_topology;
 
-        for (int i = 0; i < tmp.size(); i++) {
+        Scalar *params = index == 0 ? nullptr : m_params.data() + topology.param_offsets[index];
+        size_t inputs = index == 0 ? 0 : topology.sizes[index - 1];
 
-            if (tmp[i] > max)
-            {
-                max = tmp[i];
-                index = i;
-            }
-        }
-        return index;
+        return layer_type(m_neurons.data() + topology.neuron_offsets[index], params, topology.sizes[index], inputs, topology.activations[index]);
     }
 
-    void NeuralNetwork::crossover(NeuralNetwork const& first, NeuralNetwork const& second, double const crossover_rate) {
-        //size tot de tout les w et bias 
-        size_t tot = 0;
-        for(int i = 1; i < m_size; i++)
-            tot += m_layers[i].weights().size() + m_layers[i].bias().size();
-        
-
-        size_t cut = (tot * crossover_rate);
-        size_t remains = tot - cut;
-        
-        int layer = 1;
-
-        while (cut != 0)
-        {
-
-            auto& current_layer = m_layers[layer];
-            auto& other_layer = first[layer];
-
-            size_t nweights = current_layer.weights().size();
-            size_t nbias = current_layer.bias().size();
-
-            auto& current_weigths = current_layer.weights();
-            auto& other_weigths = other_layer.weights();
-
-            auto& current_bias = current_layer.weights();
-            auto& other_bias = other_layer.weights();
-
-            for (int i = 0; i < nweights && cut != 0; i++) {
-                current_weigths[i] = other_weigths[i];
-                cut--;
-            }
-
-            for (int i = 0; i < nbias && cut != 0; i++) {
-                current_bias[i] = other_bias[i];
-                cut--;
-            }
-            layer++;
-        }
-
-        layer = m_layers.size() - 1;
-
-        while (remains != 0)
-        {
-            auto& current_layer = m_layers[layer];
-            auto& other_layer = second[layer];
-
-            size_t nweights = current_layer.weights().size();
-            size_t nbias = current_layer.bias().size();
+    template <typename Scalar>
+    typename BasicNeuralNetwork<Scalar>::layer_type const BasicNeuralNetwork<Scalar>::operator[](size_t index) const {
+        return const_cast<BasicNeuralNetwork &>(*this)[index];
+    }
 
-            auto& current_weigths = current_layer.weights();
-            auto& other_weigths = other_layer.weights();
+    template <typename Scalar>
+    void BasicNeuralNetwork<Scalar>::forward(Scalar const* inputs, bool output_activation){
 
-            auto& current_bias = current_layer.weights();
-            auto& other_bias = other_layer.weights();
+        layer_type previous = (*this)[0];
+        previous.compute(inputs);
 
-            for (int i = nbias - 1; i != 0 && remains != 0; i--) {
-                current_bias[i] = other_bias[i];
-                remains--;
-            }
+        for(size_t i = 1; i < size(); i++) {
+            layer_type current = (*this)[i];
 
-            for (int i = nweights - 1; i != 0 && remains != 0; i--) {
-                current_weigths[i] = other_weigths[i];
-                remains--;
-            }
+            if (i + 1 < size() || output_activation)
+                current.compute(previous);
+            else
+                current.computeLinear(previous);
 
-            layer--;
+            previous = current;
         }
     }
 
-    void NeuralNetwork::mutate(double const mutation_rate) {
-        for(int i = 1; i < m_size; i++)
-            m_layers[i].mutate(mutation_rate);
+    template <typename Scalar>
+    size_t BasicNeuralNetwork<Scalar>::compute(std::vector<Scalar> const& inputs){
+        return compute(util::Span<Scalar const>(inputs));
     }
 
-
-
-    //////////////////////////////////////////////////////////////////////////////////////////////////
-    /////                                     Population                                         /////
-    //////////////////////////////////////////////////////////////////////////////////////////////////
-    
-    NeuralNetwork& Population::pickOne(){
-        size_t index = 0;
-
-        double r = (double) rand() / (double) RAND_MAX;
-        auto& population = *m_curr_population;
-
-        while ( r > 0) {
-            r -= population[index].m_fitness;
-
-            index += 1;
-        }
-        if (index == 0)
-            index = 1;
-            
-        return population[index - 1];
+    template <typename Scalar>
+    size_t BasicNeuralNetwork<Scalar>::compute(Scalar const* inputs, size_t n){
+        return compute(util::Span<Scalar const>(inputs, n));
     }
 
+    template <typename Scalar>
+    size_t BasicNeuralNetwork<Scalar>::compute(util::Span<Scalar const> inputs){
+        if (inputs.size() < m_topology->sizes.front())
+            throw std::invalid_argument("NeuralNetwork : pas assez d'entrees");
 
-    void Population::calculateFitness(){
-        double sum = 0;
-
-        auto& population = *m_curr_population;
-
-        for( int i = 0; i < m_size; i++)
-            sum += population[i].score();
-
-        for( int i = 0; i < m_size; i++)
-            population[i].fitness(population[i].score()  / sum);
+        forward(inputs.data(), true);
+        return output();
     }
 
+    template <typename Scalar>
+    size_t BasicNeuralNetwork<Scalar>::compute(util::Span<Scalar const> inputs, util::Span<Scalar> outputs){
+        if (outputs.size() < m_topology->sizes.back())
+            throw std::invalid_argument("NeuralNetwork : buffer de sortie trop petit");
 
-    void Population::evolve(){
-        for( int i = 0; i < m_size; i++){
-            NeuralNetwork& tmp = (*m_old_population)[i];
+        size_t res = compute(inputs);
 
-            tmp.crossover(pickOne(), pickOne(), m_params.crossover_rate);
-            tmp.mutate(m_params.mutation_rate);
-        }
-        std::swap(m_curr_population, m_old_population);
+        Scalar const *last = m_neurons.data() + m_topology->neuron_offsets.back();
+        std::copy(last, last + m_topology->sizes.back(), outputs.data());
+        return res;
     }
 
+    template <typename Scalar>
+    size_t BasicNeuralNetwork<Scalar>::computeArgmax(util::Span<Scalar const> inputs){
+        if (inputs.size() < m_topology->sizes.front())
+            throw std::invalid_argument("NeuralNetwork : pas assez d'entrees");
 
-    Population::Population(unsigned population_size, NeuralParameters const &params) : m_size(population_size), m_params(params) {
-        NeuralNetwork buffer(params);
-
-        m_first_population.resize(population_size, buffer);
-        m_second_population.resize(population_size, buffer);
-
-        m_curr_population = &m_first_population;
-        m_old_population = &m_second_population;
-    }
-
-    Population::Population(Population const &other) {
-        *this = other;
+        forward(inputs.data(), !ActivationRegistry::singleton()[m_topology->activations.back()].strictly_increasing);
+        return output();
     }
 
-    Population::Population(Population&& other) {
-        *this = other;
-    }
+    template <typename Scalar>
+    size_t BasicNeuralNetwork<Scalar>::output() const {
 
-    Population &Population::operator=(Population const &other) {
+        
+        Scalar const *tmp = m_neurons.data() + m_topology->neuron_offsets.back();
+        size_t n = m_topology->sizes.back();
+        
+        Scalar max = tmp[0];
+        size_t index = 0;
 
-        m_first_population = other.m_first_population;
-        m_second_population = other.m_second_population;
+        for (size_t i = 0; i < n; i++) {
 
-        m_params = other.m_params;
-        return *this;
+            if (tmp[i] > max)
+            {
+                max = tmp[i];
+                index = i;
+            }
+        }
+        return index;
     }
 
-    Population &Population::operator=(Population&& other) {
-
-        m_first_population = std::move(other.m_first_population);
-        m_second_population = std::move(other.m_second_population);
+    template <typename Scalar>
+    void BasicNeuralNetwork<Scalar>::crossover(BasicNeuralNetwork const& first, BasicNeuralNetwork const& second, double const crossover_rate) {
+        // le buffer est parcouru couche par couche, poids puis biais :
+        // les cut premiers paramètres viennent du premier parent, le reste du second
+        size_t tot = m_params.size();
+        size_t cut = (tot * crossover_rate);
 
-        m_params = other.m_params;
-        return *this;
+        recombination::onePoint(params(), first.params(), second.params(), cut);
+        m_hash = hashing::splice(first.params(), first.m_hash, second.params(), second.m_hash, cut, tot);
     }
 
-    void Population::run(Game &game){
-        std::vector<NeuralNetwork>& population = *m_curr_population;
-
-        for (auto& i : population) {
-            game(i);
+    template <typename Scalar>
+    void BasicNeuralNetwork<Scalar>::crossover(BasicNeuralNetwork const& first, BasicNeuralNetwork const& second, crossover_t type, double const crossover_rate, util::Random &rng) {
+        // les couches commencent aux param_offsets, la couche d'entrée n'a pas de paramètres
+        util::Span<size_t const> blocks(m_topology->param_offsets.data() + 1, m_topology->param_offsets.size() - 1);
+
+        size_t begin, end;
+
+        switch (type) {
+            case crossover_t::OnePoint:
+                crossover(first, second, crossover_rate);
+                break;
+
+            case crossover_t::TwoPoint:
+                // empreinte mise à jour sur le segment seulement
+                recombination::twoPointRange(m_params.size(), crossover_rate, rng, begin, end);
+                recombination::twoPoint(params(), first.params(), second.params(), begin, end);
+                m_hash = hashing::splice(first.params(), first.m_hash, second.params(), second.m_hash, begin, end);
+                break;
+
+            default:
+                recombination::apply(type, params(), first.params(), second.params(), crossover_rate, blocks, rng);
+
+                // même parent deux fois : l'enfant est une copie, sauf pour la moyenne (arrondis)
+                if (&first == &second && type != crossover_t::Arithmetic)
+                    m_hash = first.m_hash;
+                else
+                    rehash();
+                break;
         }
-        calculateFitness();
-        evolve();
     }
 
-    NeuralNetwork &Population::bestElement(){
-        std::vector<NeuralNetwork>& population = *m_curr_population;
-
-        NeuralNetwork* res = &population[0];
-        size_t max = population[0].score();
+    template <typename Scalar>
+    void BasicNeuralNetwork<Scalar>::rehash() {
+        m_hash = hashing::genome<Scalar>(params());
+    }
 
-        for (auto& i : population) {
-            if (i.score() > max)
-            {
-                max = i.score();
-                res = &i;
-            }
-        }
-        return *res;
+    template <typename Scalar>
+    void BasicNeuralNetwork<Scalar>::mutate(double const mutation_rate) {
+        util::Random rng(util::threadRandom()());
+        mutate(mutation_rate, rng);
     }
 
-    NeuralNetwork const &Population::bestElement() const{
-        return bestElement();
+    template <typename Scalar>
+    void BasicNeuralNetwork<Scalar>::mutate(double const mutation_rate, util::Random &rng, double const sigma) {
+        // tout le génome d'un coup : les sauts ne s'arrêtent pas aux frontières de couche
+        mutation::gaussian(params(), mutation_rate, sigma, rng, &m_hash);
     }
-        
 
 
+
+    template class BasicLayer<float>;
+    template class BasicLayer<double>;
+    template class BasicNeuralNetwork<float>;
+    template class BasicNeuralNetwork<double>;
+    template class BasicPopulation<NeuralNetworkf>;
+    template class BasicPopulation<NeuralNetwork>;
+
 }
\ No newline at end of file
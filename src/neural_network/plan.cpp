@@ -0,0 +1,224 @@
+#include "neural_network/plan.hpp"
+#include "neural_network/neat.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace neuralnetwork
+{
+
+    template <typename Scalar>
+    void BasicExecutionPlan<Scalar>::reset(size_t ninput, activation_t input_activation) {
+        m_ninput = ninput;
+        m_input_activation = input_activation;
+
+        m_code.clear();
+        m_sources.clear();
+        m_weight_index.clear();
+        m_bias_index.clear();
+        m_outputs.clear();
+    }
+
+    template <typename Scalar>
+    void BasicExecutionPlan<Scalar>::emit(uint32_t slot, uint32_t bias, activation_t activation) {
+        m_code.push_back({slot, (uint32_t)m_sources.size(), ActivationRegistry::singleton()[activation].functions<Scalar>().scalar});
+        m_bias_index.push_back(bias);
+    }
+
+    template <typename Scalar>
+    void BasicExecutionPlan<Scalar>::compile(BasicNeatNetwork<Scalar> const &network) {
+        std::vector<neat::NodeGene> const &nodes = network.nodes();
+        std::vector<neat::ConnectionGene> const &connections = network.connections();
+
+        size_t const ni = network.config().ninput, no = network.config().noutput;
+        size_t const n = nodes.size();
+
+        reset(ni, network.config().input_activation);
+
+        auto index = [&](uint64_t id) -> uint32_t {
+            return std::lower_bound(nodes.begin(), nodes.end(), id, [](neat::NodeGene const &node, uint64_t id) { return node.id < id; }) -
+                   nodes.begin();
+        };
+
+        // connexions actives regroupées par destination
+        std::vector<uint32_t> first(n + 1, 0), incoming;
+
+        for (neat::ConnectionGene const &c : connections)
+            if (c.enabled)
+                first[index(c.out) + 1]++;
+
+        for (size_t i = 0; i < n; i++)
+            first[i + 1] += first[i];
+
+        incoming.resize(first[n]);
+        std::vector<uint32_t> cursor(first.begin(), first.end() - 1);
+
+        for (size_t c = 0; c < connections.size(); c++)
+            if (connections[c].enabled)
+                incoming[cursor[index(connections[c].out)]++] = c;
+
+        // parcours en profondeur depuis les sorties en remontant les connexions : l'ordre de fin de visite
+        // est topologique et ne contient que les noeuds dont une sortie dépend
+        std::vector<uint32_t> slot(n, UINT32_MAX);
+        std::vector<std::pair<uint32_t, uint32_t>> stack; // (noeud, prochaine connexion entrante)
+        std::vector<uint32_t> order;
+        std::vector<bool> visited(n, false);
+
+        for (size_t i = 0; i < ni; i++) {
+            slot[i] = i;
+            visited[i] = true;
+        }
+
+        for (size_t o = ni; o < ni + no; o++) {
+            if (visited[o])
+                continue;
+
+            visited[o] = true;
+            stack.push_back({o, first[o]});
+
+            while (!stack.empty()) {
+                std::pair<uint32_t, uint32_t> &top = stack.back();
+
+                if (top.second == first[top.first + 1]) {
+                    order.push_back(top.first);
+                    stack.pop_back();
+                    continue;
+                }
+
+                uint32_t source = index(connections[incoming[top.second++]].in);
+                if (!visited[source]) {
+                    visited[source] = true;
+                    stack.push_back({source, first[source]});
+                }
+            }
+        }
+
+        // une case par noeud dans l'ordre d'exécution, termes triés par case source
+        std::vector<std::pair<uint32_t, uint32_t>> terms;
+
+        for (uint32_t node : order) {
+            slot[node] = ni + m_code.size();
+
+            terms.clear();
+            for (uint32_t e = first[node]; e < first[node + 1]; e++)
+                terms.push_back({slot[index(connections[incoming[e]].in)], incoming[e]});
+            std::sort(terms.begin(), terms.end());
+
+            for (std::pair<uint32_t, uint32_t> const &term : terms) {
+                m_sources.push_back(term.first);
+                m_weight_index.push_back(term.second);
+            }
+
+            emit(slot[node], connections.size() + node - ni, nodes[node].activation);
+        }
+
+        for (size_t o = ni; o < ni + no; o++)
+            m_outputs.push_back(slot[o]);
+
+        m_values.assign(ni + m_code.size(), 0);
+        bind(network.params());
+    }
+
+    template <typename Scalar>
+    void BasicExecutionPlan<Scalar>::compile(BasicNeuralNetwork<Scalar> const &network) {
+        Topology const &topology = network.topology();
+        util::Span<Scalar const> params = network.params();
+        size_t const nlayers = topology.sizes.size();
+
+        reset(topology.sizes.front(), topology.activations.front());
+
+        auto weight = [&](size_t layer, size_t i, size_t j) { return topology.param_offsets[layer] + i * topology.sizes[layer - 1] + j; };
+
+        // un neurone caché est vivant si un poids non nul le relie à un neurone vivant de la couche suivante
+        std::vector<std::vector<bool>> live(nlayers);
+        live.back().assign(topology.sizes.back(), true);
+
+        for (size_t l = nlayers - 1; l-- > 1;) {
+            live[l].assign(topology.sizes[l], false);
+
+            for (size_t i = 0; i < topology.sizes[l + 1]; i++)
+                if (live[l + 1][i])
+                    for (size_t j = 0; j < topology.sizes[l]; j++)
+                        if (params[weight(l + 1, i, j)] != 0)
+                            live[l][j] = true;
+        }
+
+        live.front().assign(topology.sizes.front(), true);
+
+        // cases compactées couche par couche, entrées en tête
+        std::vector<std::vector<uint32_t>> slot(nlayers);
+        for (size_t j = 0; j < topology.sizes.front(); j++)
+            slot[0].push_back(j);
+
+        for (size_t l = 1; l < nlayers; l++) {
+            slot[l].assign(topology.sizes[l], UINT32_MAX);
+
+            for (size_t i = 0; i < topology.sizes[l]; i++) {
+                if (!live[l][i])
+                    continue;
+
+                for (size_t j = 0; j < topology.sizes[l - 1]; j++)
+                    if (params[weight(l, i, j)] != 0) {
+                        m_sources.push_back(slot[l - 1][j]);
+                        m_weight_index.push_back(weight(l, i, j));
+                    }
+
+                slot[l][i] = m_ninput + m_code.size();
+                emit(slot[l][i], topology.param_offsets[l] + topology.nweights(l) + i, topology.activations[l]);
+            }
+        }
+
+        m_outputs = slot.back();
+
+        m_values.assign(m_ninput + m_code.size(), 0);
+        bind(params);
+    }
+
+    template <typename Scalar>
+    void BasicExecutionPlan<Scalar>::bind(util::Span<Scalar const> params) {
+        m_weights.resize(m_weight_index.size());
+        m_biases.resize(m_bias_index.size());
+
+        for (size_t k = 0; k < m_weight_index.size(); k++)
+            m_weights[k] = params[m_weight_index[k]];
+
+        for (size_t i = 0; i < m_bias_index.size(); i++)
+            m_biases[i] = params[m_bias_index[i]];
+    }
+
+    template <typename Scalar>
+    size_t BasicExecutionPlan<Scalar>::run(Scalar const *inputs, Scalar *outputs) {
+        Scalar *values = m_values.data();
+        Scalar const *weights = m_weights.data();
+        uint32_t const *sources = m_sources.data();
+
+        std::copy(inputs, inputs + m_ninput, values);
+        activate(m_input_activation, values, m_ninput);
+
+        uint32_t begin = 0;
+
+        for (size_t i = 0; i < m_code.size(); i++) {
+            Instruction const &instruction = m_code[i];
+            Scalar s = m_biases[i];
+
+            for (uint32_t k = begin; k < instruction.end; k++)
+                s += weights[k] * values[sources[k]];
+
+            values[instruction.slot] = instruction.activation(s);
+            begin = instruction.end;
+        }
+
+        size_t res = 0;
+        for (size_t o = 0; o < m_outputs.size(); o++) {
+            if (values[m_outputs[o]] > values[m_outputs[res]])
+                res = o;
+            if (outputs != nullptr)
+                outputs[o] = values[m_outputs[o]];
+        }
+        return res;
+    }
+
+    template class BasicExecutionPlan<float>;
+    template class BasicExecutionPlan<double>;
+
+} // namespace neuralnetwork
@@ -0,0 +1,149 @@
+#include "neural_network/quantized.hpp"
+#include "neural_network/kernels.hpp"
+
+#include <utility>
+
+namespace neuralnetwork
+{
+
+    template <typename Scalar>
+    QuantizedNetwork::QuantizedNetwork(BasicNeuralNetwork<Scalar> const &network) : m_output(0) {
+        Topology const &topology = network.topology();
+        Scalar const *params = network.params().data();
+
+        size_t width = 0, stride = 0;
+
+        for (size_t l = 0; l < topology.sizes.size(); l++) {
+            Layer layer = {};
+            layer.size = topology.sizes[l];
+            layer.activation = topology.activations[l];
+            width = std::max(width, layer.size);
+
+            if (l > 0) {
+                layer.inputs = topology.sizes[l - 1];
+                layer.stride = (layer.inputs + 31) / 32 * 32;
+                layer.weights = m_weights.size();
+                layer.neurons = m_scales.size();
+                stride = std::max(stride, layer.stride);
+
+                Scalar const *weights = params + topology.param_offsets[l];
+                Scalar const *bias = weights + topology.nweights(l);
+
+                m_weights.resize(m_weights.size() + layer.size * layer.stride, 0);
+
+                for (size_t i = 0; i < layer.size; i++) {
+                    int8_t *row = m_weights.data() + layer.weights + i * layer.stride;
+                    m_scales.push_back(quantizeRow(weights + i * layer.inputs, layer.inputs, row));
+
+                    int32_t sum = 0;
+                    for (size_t j = 0; j < layer.inputs; j++)
+                        sum += row[j];
+
+                    m_sums.push_back(sum);
+                    m_bias.push_back(bias[i]);
+                }
+            }
+
+            m_layers.push_back(layer);
+        }
+
+        m_current.assign(width, 0);
+        m_next.assign(width, 0);
+        // forward ne réécrit que les inputs premières valeurs : après une couche plus large, la fin garde d'anciennes
+        // activations, sans effet car les poids de remplissage (colonnes inputs .. stride) sont nuls
+        m_quantized.assign(stride, 0);
+        m_dot.assign(width, 0);
+    }
+
+    size_t QuantizedNetwork::forward() {
+        activate(m_layers.front().activation, m_current.data(), m_layers.front().size);
+
+        for (size_t l = 1; l < m_layers.size(); l++) {
+            Layer const &layer = m_layers[l];
+            float const *x = m_current.data();
+
+            auto range = std::minmax_element(x, x + layer.inputs);
+            float const min = *range.first;
+            float const scale = (*range.second - min) / 127;
+            float const inverse = scale > 0 ? 1 / scale : 0;
+
+            // x[j] - min >= 0 : arrondi par troncature de v + 0.5, vectorisable
+            for (size_t j = 0; j < layer.inputs; j++)
+                m_quantized[j] = (uint8_t)std::min((x[j] - min) * inverse + 0.5f, 127.f);
+
+            kernels::dotInt8(m_weights.data() + layer.weights, m_quantized.data(), m_dot.data(), layer.size, layer.stride);
+
+            // somme_j w_j x_j = row_scale * (scale * somme_j q_j w_j + min * somme_j w_j)
+            float const *scales = m_scales.data() + layer.neurons;
+            int32_t const *sums = m_sums.data() + layer.neurons;
+            float const *bias = m_bias.data() + layer.neurons;
+
+            for (size_t i = 0; i < layer.size; i++)
+                m_next[i] = scales[i] * (scale * m_dot[i] + min * sums[i]) + bias[i];
+
+            activate(layer.activation, m_next.data(), layer.size);
+            std::swap(m_current, m_next);
+        }
+
+        m_output = std::max_element(m_current.begin(), m_current.begin() + noutput()) - m_current.begin();
+        return m_output;
+    }
+
+    template <typename Scalar>
+    size_t QuantizedNetwork::compute(util::Span<Scalar const> inputs, util::Span<float> outputs) {
+        if (inputs.size() < ninput())
+            throw std::invalid_argument("QuantizedNetwork : pas assez d'entrees");
+        if (!outputs.empty() && outputs.size() < noutput())
+            throw std::invalid_argument("QuantizedNetwork : buffer de sortie trop petit");
+
+        std::copy(inputs.begin(), inputs.begin() + ninput(), m_current.begin());
+
+        size_t res = forward();
+        if (!outputs.empty())
+            std::copy(m_current.begin(), m_current.begin() + noutput(), outputs.begin());
+        return res;
+    }
+
+    template <typename Scalar>
+    QuantizationReport compareQuantized(BasicNeuralNetwork<Scalar> const &network, QuantizedNetwork &quantized, BasicInputRecord<Scalar> const &inputs) {
+        if (inputs.ninput() != quantized.ninput() || inputs.ninput() != network.topology().sizes.front())
+            throw std::invalid_argument("compareQuantized : nombre d'entrees different du reseau");
+
+        BasicNeuralNetwork<double> reference(network);
+
+        size_t const no = quantized.noutput();
+        std::vector<double> in(inputs.ninput()), expected(no);
+        std::vector<float> actual(no);
+
+        QuantizationReport report;
+        double total = 0;
+
+        for (size_t k = 0; k < inputs.size(); k++) {
+            util::Span<Scalar const> sample = inputs[k];
+            std::copy(sample.begin(), sample.end(), in.begin());
+
+            size_t a = reference.compute(util::Span<double const>(in), util::Span<double>(expected));
+            size_t b = quantized.compute(sample, util::Span<float>(actual));
+
+            report.samples++;
+            report.agree += a == b;
+
+            for (size_t i = 0; i < no; i++) {
+                double error = std::fabs(expected[i] - actual[i]);
+                report.max_error = std::max(report.max_error, error);
+                total += error;
+            }
+        }
+
+        report.mean_error = report.samples == 0 ? 0 : total / (report.samples * no);
+        return report;
+    }
+
+    template QuantizedNetwork::QuantizedNetwork(BasicNeuralNetwork<float> const &);
+    template QuantizedNetwork::QuantizedNetwork(BasicNeuralNetwork<double> const &);
+    template size_t QuantizedNetwork::compute<float>(util::Span<float const>, util::Span<float>);
+    template size_t QuantizedNetwork::compute<double>(util::Span<double const>, util::Span<float>);
+    template QuantizationReport compareQuantized<float>(BasicNeuralNetwork<float> const &, QuantizedNetwork &, BasicInputRecord<float> const &);
+    template QuantizationReport compareQuantized<double>(BasicNeuralNetwork<double> const &, QuantizedNetwork &, BasicInputRecord<double> const &);
+
+} // namespace neuralnetwork
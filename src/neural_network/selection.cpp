@@ -0,0 +1,141 @@
+#include "neural_network/selection.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace neuralnetwork
+{
+
+    Selection::Selection(selection_t type, size_t tournament_size)
+        : m_type(type), m_tournament_size(tournament_size == 0 ? 1 : tournament_size), m_size(0), m_uniform(true), m_total(0) {}
+
+    void Selection::buildAlias(util::Span<double const> weights, double total) {
+        // méthode de Vose : chaque case i garde la probabilité m_probability[i], le reste va à m_alias[i]
+        size_t n = weights.size();
+
+        m_probability.resize(n);
+        m_alias.resize(n);
+
+        std::vector<uint32_t> small, large;
+        small.reserve(n);
+        large.reserve(n);
+
+        for (size_t i = 0; i < n; i++) {
+            m_probability[i] = weights[i] * n / total;
+            (m_probability[i] < 1 ? small : large).push_back(i);
+        }
+
+        while (!small.empty() && !large.empty()) {
+            uint32_t s = small.back();
+            uint32_t l = large.back();
+            small.pop_back();
+
+            m_alias[s] = l;
+            m_probability[l] -= 1 - m_probability[s];
+
+            if (m_probability[l] < 1) {
+                large.pop_back();
+                small.push_back(l);
+            }
+        }
+
+        // restes dus aux arrondis
+        for (uint32_t i : large)
+            m_probability[i] = 1;
+        for (uint32_t i : small)
+            m_probability[i] = 1;
+    }
+
+    void Selection::build(util::Span<double const> fitness) {
+        m_size = fitness.size();
+
+        double total = 0;
+        for (double f : fitness)
+            total += std::max(f, 0.);
+
+        m_total = total;
+        m_uniform = !(total > 0) || total == std::numeric_limits<double>::infinity();
+
+        switch (m_type) {
+            case selection_t::Roulette: {
+                m_cumulative.resize(m_size);
+
+                double sum = 0;
+                for (size_t i = 0; i < m_size; i++) {
+                    sum += std::max(fitness[i], 0.);
+                    m_cumulative[i] = sum;
+                }
+                break;
+            }
+
+            case selection_t::Alias: {
+                if (m_uniform)
+                    break;
+
+                std::vector<double> weights(m_size);
+                for (size_t i = 0; i < m_size; i++)
+                    weights[i] = std::max(fitness[i], 0.);
+
+                buildAlias(weights, total);
+                break;
+            }
+
+            case selection_t::Tournament:
+                m_fitness.assign(fitness.begin(), fitness.end());
+                break;
+
+            case selection_t::Rank: {
+                std::vector<uint32_t> order(m_size);
+                std::iota(order.begin(), order.end(), 0);
+                std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return fitness[a] < fitness[b]; });
+
+                std::vector<double> weights(m_size);
+                for (size_t r = 0; r < m_size; r++)
+                    weights[order[r]] = r + 1;
+
+                m_uniform = m_size == 0;
+                if (!m_uniform)
+                    buildAlias(weights, m_size * (m_size + 1) / 2.);
+                break;
+            }
+        }
+    }
+
+    size_t Selection::pick(util::Random &rng) const {
+        if (m_size == 0)
+            return 0;
+
+        if (m_uniform && m_type != selection_t::Tournament)
+            return std::min<size_t>(rng.uniform() * m_size, m_size - 1);
+
+        switch (m_type) {
+            case selection_t::Roulette: {
+                // premier indice dont la somme cumulée atteint r, comme l'ancien parcours linéaire
+                double r = rng.uniform() * m_cumulative.back();
+                size_t index = std::lower_bound(m_cumulative.begin(), m_cumulative.end(), r) - m_cumulative.begin();
+                return std::min(index, m_size - 1);
+            }
+
+            case selection_t::Tournament: {
+                size_t best = std::min<size_t>(rng.uniform() * m_size, m_size - 1);
+
+                for (size_t k = 1; k < m_tournament_size; k++) {
+                    size_t other = std::min<size_t>(rng.uniform() * m_size, m_size - 1);
+                    if (m_fitness[other] > m_fitness[best])
+                        best = other;
+                }
+                return best;
+            }
+
+            case selection_t::Alias:
+            case selection_t::Rank:
+            default: {
+                double x = rng.uniform() * m_size;
+                size_t index = std::min<size_t>(x, m_size - 1);
+                return x - index < m_probability[index] ? index : m_alias[index];
+            }
+        }
+    }
+
+} // namespace neuralnetwork
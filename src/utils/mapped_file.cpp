@@ -0,0 +1,81 @@
+#include "utils/mapped_file.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace util {
+
+    static std::runtime_error systemError(std::string const &what) {
+        return std::runtime_error("MappedFile : " + what + " : " + std::strerror(errno));
+    }
+
+    MappedFile MappedFile::open(std::string const &path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw systemError("open " + path);
+
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            std::runtime_error error = systemError("fstat " + path);
+            close(fd);
+            throw error;
+        }
+
+        if (info.st_size == 0) {
+            close(fd);
+            throw std::runtime_error("MappedFile : fichier vide " + path);
+        }
+
+        void *data = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+
+        if (data == MAP_FAILED)
+            throw systemError("mmap " + path);
+
+        return MappedFile(data, info.st_size);
+    }
+
+    MappedFile::MappedFile(MappedFile &&other) : m_data(other.m_data), m_size(other.m_size) {
+        other.m_data = nullptr;
+        other.m_size = 0;
+    }
+
+    MappedFile &MappedFile::operator=(MappedFile &&other) {
+        if (this != &other) {
+            release();
+
+            m_data = other.m_data;
+            m_size = other.m_size;
+
+            other.m_data = nullptr;
+            other.m_size = 0;
+        }
+        return *this;
+    }
+
+    MappedFile::~MappedFile() {
+        release();
+    }
+
+    void MappedFile::sequential() const {
+        if (m_data != nullptr) {
+            madvise(m_data, m_size, MADV_SEQUENTIAL);
+            madvise(m_data, m_size, MADV_WILLNEED);
+        }
+    }
+
+    void MappedFile::release() {
+        if (m_data != nullptr)
+            munmap(m_data, m_size);
+
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+}
@@ -0,0 +1,151 @@
+#include "utils/random.hpp"
+
+#include <atomic>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define UTIL_RANDOM_X86
+#include <immintrin.h>
+#endif
+
+namespace util {
+
+    FastRandom &threadRandom() {
+        // chaque thread reçoit une graine différente, dans l'ordre de premier appel
+        static std::atomic<uint64_t> counter(0);
+        thread_local FastRandom random(mix64(counter.fetch_add(1)));
+        return random;
+    }
+
+    namespace detail {
+
+        static void boxMullerScalar(double *values, size_t n) {
+            for (size_t b = 0; b < n; b += 8) {
+                for (size_t i = 0; i < 4; i++) {
+                    double const r = std::sqrt(-2. * std::log(values[b + i]));
+                    double const angle = 2 * M_PI * values[b + 4 + i];
+
+                    values[b + i] = r * std::cos(angle);
+                    values[b + 4 + i] = r * std::sin(angle);
+                }
+            }
+        }
+
+#ifdef UTIL_RANDOM_X86
+
+        // log(x) pour x > 0 normalisé : x = m 2^e avec m dans [sqrt(2)/2, sqrt(2)[,
+        // log(m) = 2 atanh(f) avec f = (m - 1) / (m + 1), série en f² jusqu'au degré 21
+        __attribute__((target("avx2,fma")))
+        static __m256d logAVX2(__m256d x) {
+            __m256i const bits = _mm256_castpd_si256(x);
+
+            __m256i const mantissa_mask = _mm256_set1_epi64x(0x000FFFFFFFFFFFFFll);
+            __m256i const one_bits = _mm256_set1_epi64x(0x3FF0000000000000ll);
+
+            __m256d m = _mm256_castsi256_pd(_mm256_or_si256(_mm256_and_si256(bits, mantissa_mask), one_bits));
+            __m256i e = _mm256_sub_epi64(_mm256_srli_epi64(bits, 52), _mm256_set1_epi64x(1023));
+
+            __m256d const big = _mm256_cmp_pd(m, _mm256_set1_pd(M_SQRT2), _CMP_GT_OQ);
+            m = _mm256_blendv_pd(m, _mm256_mul_pd(m, _mm256_set1_pd(0.5)), big);
+            e = _mm256_sub_epi64(e, _mm256_castpd_si256(big)); // big vaut -1 par voie
+
+            // int64 -> double sans AVX-512 : e + 1.5 * 2^52 lu comme un double
+            __m256d const magic = _mm256_set1_pd(6755399441055744.0);
+            __m256d const ed = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_add_epi64(e, _mm256_castpd_si256(magic))), magic);
+
+            __m256d const one = _mm256_set1_pd(1.);
+            __m256d const f = _mm256_div_pd(_mm256_sub_pd(m, one), _mm256_add_pd(m, one));
+            __m256d const s = _mm256_mul_pd(f, f);
+
+            __m256d p = _mm256_set1_pd(1. / 21);
+            p = _mm256_fmadd_pd(p, s, _mm256_set1_pd(1. / 19));
+            p = _mm256_fmadd_pd(p, s, _mm256_set1_pd(1. / 17));
+            p = _mm256_fmadd_pd(p, s, _mm256_set1_pd(1. / 15));
+            p = _mm256_fmadd_pd(p, s, _mm256_set1_pd(1. / 13));
+            p = _mm256_fmadd_pd(p, s, _mm256_set1_pd(1. / 11));
+            p = _mm256_fmadd_pd(p, s, _mm256_set1_pd(1. / 9));
+            p = _mm256_fmadd_pd(p, s, _mm256_set1_pd(1. / 7));
+            p = _mm256_fmadd_pd(p, s, _mm256_set1_pd(1. / 5));
+            p = _mm256_fmadd_pd(p, s, _mm256_set1_pd(1. / 3));
+            p = _mm256_fmadd_pd(p, s, one);
+
+            __m256d const logm = _mm256_mul_pd(_mm256_add_pd(f, f), p);
+            return _mm256_fmadd_pd(ed, _mm256_set1_pd(M_LN2), logm);
+        }
+
+        // sin et cos de 2 pi u : réduction exacte sur u au quart de tour le plus proche,
+        // puis polynômes de Taylor sur [-pi/4, pi/4] et rotation selon le quadrant
+        __attribute__((target("avx2,fma")))
+        static void sincosAVX2(__m256d u, __m256d &sin, __m256d &cos) {
+            __m256d const t = _mm256_sub_pd(u, _mm256_round_pd(u, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+            __m256d const q = _mm256_round_pd(_mm256_mul_pd(t, _mm256_set1_pd(4.)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+
+            __m256d const a = _mm256_mul_pd(_mm256_fnmadd_pd(q, _mm256_set1_pd(0.25), t), _mm256_set1_pd(2 * M_PI));
+            __m256d const a2 = _mm256_mul_pd(a, a);
+
+            __m256d ps = _mm256_set1_pd(-1. / 1307674368000.); // -1/15!
+            ps = _mm256_fmadd_pd(ps, a2, _mm256_set1_pd(1. / 6227020800.));
+            ps = _mm256_fmadd_pd(ps, a2, _mm256_set1_pd(-1. / 39916800.));
+            ps = _mm256_fmadd_pd(ps, a2, _mm256_set1_pd(1. / 362880.));
+            ps = _mm256_fmadd_pd(ps, a2, _mm256_set1_pd(-1. / 5040.));
+            ps = _mm256_fmadd_pd(ps, a2, _mm256_set1_pd(1. / 120.));
+            ps = _mm256_fmadd_pd(ps, a2, _mm256_set1_pd(-1. / 6.));
+            ps = _mm256_fmadd_pd(ps, a2, _mm256_set1_pd(1.));
+            __m256d const s = _mm256_mul_pd(ps, a);
+
+            __m256d pc = _mm256_set1_pd(1. / 20922789888000.); // 1/16!
+            pc = _mm256_fmadd_pd(pc, a2, _mm256_set1_pd(-1. / 87178291200.));
+            pc = _mm256_fmadd_pd(pc, a2, _mm256_set1_pd(1. / 479001600.));
+            pc = _mm256_fmadd_pd(pc, a2, _mm256_set1_pd(-1. / 3628800.));
+            pc = _mm256_fmadd_pd(pc, a2, _mm256_set1_pd(1. / 40320.));
+            pc = _mm256_fmadd_pd(pc, a2, _mm256_set1_pd(-1. / 720.));
+            pc = _mm256_fmadd_pd(pc, a2, _mm256_set1_pd(1. / 24.));
+            pc = _mm256_fmadd_pd(pc, a2, _mm256_set1_pd(-1. / 2.));
+            __m256d const c = _mm256_fmadd_pd(pc, a2, _mm256_set1_pd(1.));
+
+            // quadrant k = q mod 4 : sin(a + k pi/2) = (s, c, -s, -c), cos(a + k pi/2) = (c, -s, -c, s)
+            __m256i const k = _mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(q));
+            __m256i const one = _mm256_set1_epi64x(1);
+            __m256i const two = _mm256_set1_epi64x(2);
+
+            __m256d const odd = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(k, one), one));
+            __m256d const sin_sign = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_and_si256(k, two), 62));
+            __m256d const cos_sign = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_and_si256(_mm256_add_epi64(k, one), two), 62));
+
+            sin = _mm256_xor_pd(_mm256_blendv_pd(s, c, odd), sin_sign);
+            cos = _mm256_xor_pd(_mm256_blendv_pd(c, s, odd), cos_sign);
+        }
+
+        __attribute__((target("avx2,fma")))
+        static void boxMullerAVX2(double *values, size_t n) {
+            for (size_t b = 0; b < n; b += 8) {
+                __m256d const u1 = _mm256_loadu_pd(values + b);
+                __m256d const u2 = _mm256_loadu_pd(values + b + 4);
+
+                __m256d const r = _mm256_sqrt_pd(_mm256_mul_pd(_mm256_set1_pd(-2.), logAVX2(u1)));
+
+                __m256d sin, cos;
+                sincosAVX2(u2, sin, cos);
+
+                _mm256_storeu_pd(values + b, _mm256_mul_pd(r, cos));
+                _mm256_storeu_pd(values + b + 4, _mm256_mul_pd(r, sin));
+            }
+        }
+
+#endif
+
+        static void (*selectBoxMuller())(double *, size_t) {
+#ifdef UTIL_RANDOM_X86
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+                return boxMullerAVX2;
+#endif
+            return boxMullerScalar;
+        }
+
+        void boxMuller(double *values, size_t n) {
+            static void (*const impl)(double *, size_t) = selectBoxMuller();
+            impl(values, n);
+        }
+
+    }
+
+}
@@ -0,0 +1,144 @@
+#include "utils/scheduler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace std::chrono;
+
+namespace util {
+
+    double SchedulerStats::idleRatio() const {
+        double total = wall * idle.size();
+
+        if (total <= 0)
+            return 0;
+
+        double sum = 0;
+        for (double i : idle)
+            sum += i;
+
+        return sum / total;
+    }
+
+    WorkStealingScheduler::WorkStealingScheduler(size_t chunk) : m_chunk(chunk) {}
+
+    bool WorkStealingScheduler::pop(size_t worker, Range &range) {
+        Queue &queue = *m_queues[worker];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (queue.ranges.empty())
+            return false;
+
+        range = queue.ranges.back();
+        queue.ranges.pop_back();
+        return true;
+    }
+
+    bool WorkStealingScheduler::steal(size_t worker, size_t victim) {
+        std::deque<Range> stolen;
+
+        {
+            Queue &queue = *m_queues[victim];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+
+            size_t count = (queue.ranges.size() + 1) / 2;
+
+            for (size_t i = 0; i < count; i++) {
+                stolen.push_back(queue.ranges.front());
+                queue.ranges.pop_front();
+            }
+        }
+
+        if (stolen.empty())
+            return false;
+
+        Queue &queue = *m_queues[worker];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        for (auto &range : stolen)
+            queue.ranges.push_back(range);
+
+        return true;
+    }
+
+    void WorkStealingScheduler::run(ThreadPool &pool, size_t n, std::function<void(size_t, size_t)> const &task) {
+        size_t const nworkers = pool.size();
+
+        size_t chunk = m_chunk;
+        if (chunk == 0)
+            chunk = std::max<size_t>(1, n / (nworkers * 16));
+
+        size_t const nchunks = (n + chunk - 1) / chunk;
+
+        while (m_queues.size() < nworkers)
+            m_queues.push_back(std::make_unique<Queue>());
+
+        // répartition initiale contigue, comme un découpage statique
+        for (size_t w = 0; w < nworkers; w++) {
+            auto &ranges = m_queues[w]->ranges;
+            ranges.clear();
+
+            size_t first = nchunks * w / nworkers;
+            size_t last = nchunks * (w + 1) / nworkers;
+
+            // le worker dépile par la fin : on empile à l'envers pour parcourir ses indices dans l'ordre
+            for (size_t c = last; c-- > first;)
+                ranges.push_back({c * chunk, std::min(n, (c + 1) * chunk)});
+        }
+
+        std::atomic<size_t> remaining(nchunks);
+        std::atomic<size_t> chunks(0), steals(0), failed_steals(0);
+
+        m_stats.busy.assign(nworkers, 0);
+        m_stats.idle.assign(nworkers, 0);
+
+        auto start = steady_clock::now();
+
+        pool.run([&](size_t worker) {
+            double busy = 0;
+            Range range;
+
+            while (remaining.load(std::memory_order_acquire) != 0) {
+                if (pop(worker, range)) {
+                    remaining.fetch_sub(1, std::memory_order_acq_rel);
+
+                    auto begin = steady_clock::now();
+                    for (size_t i = range.begin; i < range.end; i++)
+                        task(worker, i);
+                    busy += duration<double>(steady_clock::now() - begin).count();
+
+                    chunks.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+
+                // file vide : on tente les autres workers, en partant du suivant
+                bool found = false;
+
+                for (size_t k = 1; k < nworkers && !found; k++) {
+                    if (steal(worker, (worker + k) % nworkers)) {
+                        steals.fetch_add(1, std::memory_order_relaxed);
+                        found = true;
+                    } else {
+                        failed_steals.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+
+                if (!found)
+                    std::this_thread::yield();
+            }
+
+            m_stats.busy[worker] = busy;
+        });
+
+        m_stats.wall = duration<double>(steady_clock::now() - start).count();
+        m_stats.chunks = chunks;
+        m_stats.steals = steals;
+        m_stats.failed_steals = failed_steals;
+
+        for (size_t w = 0; w < nworkers; w++)
+            m_stats.idle[w] = std::max(0., m_stats.wall - m_stats.busy[w]);
+    }
+
+}
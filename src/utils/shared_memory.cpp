@@ -0,0 +1,111 @@
+#include "utils/shared_memory.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace util {
+
+    static std::runtime_error systemError(std::string const &what) {
+        return std::runtime_error("SharedMemory : " + what + " : " + std::strerror(errno));
+    }
+
+    SharedMemory SharedMemory::create(size_t size, std::string const &name) {
+        if (size == 0)
+            throw std::invalid_argument("SharedMemory : taille nulle");
+
+        if (name.empty()) {
+            void *data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+            if (data == MAP_FAILED)
+                throw systemError("mmap");
+            return SharedMemory(data, size, name, false);
+        }
+
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0)
+            throw systemError("shm_open " + name);
+
+        if (ftruncate(fd, size) != 0) {
+            std::runtime_error error = systemError("ftruncate " + name);
+            close(fd);
+            shm_unlink(name.c_str());
+            throw error;
+        }
+
+        void *data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+
+        if (data == MAP_FAILED) {
+            std::runtime_error error = systemError("mmap " + name);
+            shm_unlink(name.c_str());
+            throw error;
+        }
+
+        return SharedMemory(data, size, name, true);
+    }
+
+    SharedMemory SharedMemory::open(std::string const &name) {
+        int fd = shm_open(name.c_str(), O_RDWR, 0);
+        if (fd < 0)
+            throw systemError("shm_open " + name);
+
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size == 0) {
+            std::runtime_error error = systemError("fstat " + name);
+            close(fd);
+            throw error;
+        }
+
+        void *data = mmap(nullptr, info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+
+        if (data == MAP_FAILED)
+            throw systemError("mmap " + name);
+
+        return SharedMemory(data, info.st_size, name, false);
+    }
+
+    SharedMemory::SharedMemory(SharedMemory &&other)
+        : m_data(other.m_data), m_size(other.m_size), m_name(std::move(other.m_name)), m_owner(other.m_owner) {
+        other.m_data = nullptr;
+        other.m_size = 0;
+        other.m_owner = false;
+    }
+
+    SharedMemory &SharedMemory::operator=(SharedMemory &&other) {
+        if (this != &other) {
+            release();
+
+            m_data = other.m_data;
+            m_size = other.m_size;
+            m_name = std::move(other.m_name);
+            m_owner = other.m_owner;
+
+            other.m_data = nullptr;
+            other.m_size = 0;
+            other.m_owner = false;
+        }
+        return *this;
+    }
+
+    SharedMemory::~SharedMemory() {
+        release();
+    }
+
+    void SharedMemory::release() {
+        if (m_data != nullptr)
+            munmap(m_data, m_size);
+        if (m_owner)
+            shm_unlink(m_name.c_str());
+
+        m_data = nullptr;
+        m_size = 0;
+        m_owner = false;
+    }
+
+}
@@ -0,0 +1,204 @@
+#include "utils/statistics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace util {
+
+    RunningStats::RunningStats() {
+        clear();
+    }
+
+    void RunningStats::add(double value) {
+        m_count++;
+
+        double const delta = value - m_mean;
+        m_mean += delta / m_count;
+        m_m2 += delta * (value - m_mean);
+
+        m_min = std::min(m_min, value);
+        m_max = std::max(m_max, value);
+    }
+
+    void RunningStats::merge(RunningStats const &other) {
+        if (other.m_count == 0)
+            return;
+        if (m_count == 0) {
+            *this = other;
+            return;
+        }
+
+        size_t const count = m_count + other.m_count;
+        double const delta = other.m_mean - m_mean;
+
+        m_mean += delta * other.m_count / count;
+        m_m2 += other.m_m2 + delta * delta * ((double)m_count * other.m_count / count);
+        m_count = count;
+
+        m_min = std::min(m_min, other.m_min);
+        m_max = std::max(m_max, other.m_max);
+    }
+
+    void RunningStats::clear() {
+        m_count = 0;
+        m_mean = 0;
+        m_m2 = 0;
+        m_min = std::numeric_limits<double>::infinity();
+        m_max = -std::numeric_limits<double>::infinity();
+    }
+
+    double RunningStats::stddev() const {
+        return std::sqrt(variance());
+    }
+
+    void QuantileSketch::Store::add(int key, uint64_t count) {
+        if (counts.empty()) {
+            offset = key;
+            counts.push_back(0);
+        } else if (key < offset) {
+            counts.insert(counts.begin(), offset - key, 0);
+            offset = key;
+        } else if (key >= offset + (int)counts.size()) {
+            counts.resize(key - offset + 1, 0);
+        }
+
+        counts[key - offset] += count;
+    }
+
+    void QuantileSketch::Store::merge(Store const &other) {
+        for (size_t i = 0; i < other.counts.size(); i++)
+            if (other.counts[i] != 0)
+                add(other.offset + (int)i, other.counts[i]);
+    }
+
+    QuantileSketch::QuantileSketch(double accuracy) : m_accuracy(accuracy), m_zero(0), m_count(0) {
+        if (accuracy <= 0 || accuracy >= 1)
+            throw std::invalid_argument("QuantileSketch : accuracy doit etre dans ]0, 1[");
+
+        m_gamma = (1 + accuracy) / (1 - accuracy);
+        m_log_gamma = std::log(m_gamma);
+    }
+
+    // |value| est dans ]gamma^(key - 1), gamma^key]
+    int QuantileSketch::key(double value) const {
+        return (int)std::ceil(std::log(value) / m_log_gamma);
+    }
+
+    // milieu relatif de l'intervalle : erreur relative au plus accuracy
+    double QuantileSketch::value(int key) const {
+        return 2 * std::pow(m_gamma, key) / (m_gamma + 1);
+    }
+
+    void QuantileSketch::add(double value) {
+        // en dessous, l'intervalle logarithmique n'est plus représentable : compté comme zéro
+        static double const MIN_VALUE = 1e-300;
+
+        if (std::isnan(value))
+            return;
+
+        if (value > MIN_VALUE)
+            m_positive.add(key(value), 1);
+        else if (value < -MIN_VALUE)
+            m_negative.add(key(-value), 1);
+        else
+            m_zero++;
+
+        m_count++;
+    }
+
+    void QuantileSketch::merge(QuantileSketch const &other) {
+        if (other.m_accuracy != m_accuracy)
+            throw std::invalid_argument("QuantileSketch : fusion de precisions differentes");
+
+        m_positive.merge(other.m_positive);
+        m_negative.merge(other.m_negative);
+        m_zero += other.m_zero;
+        m_count += other.m_count;
+    }
+
+    void QuantileSketch::clear() {
+        m_positive.counts.clear();
+        m_negative.counts.clear();
+        m_zero = 0;
+        m_count = 0;
+    }
+
+    double QuantileSketch::quantile(double q) const {
+        if (m_count == 0)
+            return 0;
+
+        q = std::min(std::max(q, 0.), 1.);
+        uint64_t const rank = (uint64_t)(q * (m_count - 1));
+
+        // parcours croissant : négatifs du plus grand |x| au plus petit, zéros, puis positifs
+        uint64_t seen = 0;
+
+        for (size_t i = m_negative.counts.size(); i-- > 0;) {
+            seen += m_negative.counts[i];
+            if (seen > rank)
+                return -value(m_negative.offset + (int)i);
+        }
+
+        seen += m_zero;
+        if (seen > rank)
+            return 0;
+
+        for (size_t i = 0; i < m_positive.counts.size(); i++) {
+            seen += m_positive.counts[i];
+            if (seen > rank)
+                return value(m_positive.offset + (int)i);
+        }
+
+        return value(m_positive.offset + (int)m_positive.counts.size() - 1);
+    }
+
+    // m_entries reste trié par better, de la meilleure à la moins bonne : la dernière est celle à remplacer
+    void TopK::add(double value, uint64_t id) {
+        if (m_capacity == 0 || std::isnan(value))
+            return;
+
+        Entry const entry = {value, id};
+
+        if (m_entries.size() == m_capacity) {
+            if (!better(entry, m_entries.back()))
+                return;
+            m_entries.pop_back();
+        }
+
+        m_entries.insert(std::upper_bound(m_entries.begin(), m_entries.end(), entry, better), entry);
+    }
+
+    void TopK::merge(TopK const &other) {
+        if (m_capacity == 0)
+            return;
+
+        for (Entry const &entry : other.m_entries) {
+            // other est trié : une entrée refusée, les suivantes le seront aussi
+            if (m_entries.size() == m_capacity && !better(entry, m_entries.back()))
+                break;
+            add(entry.value, entry.id);
+        }
+    }
+
+    void TopK::capacity(size_t capacity) {
+        m_capacity = capacity;
+
+        if (m_entries.size() > capacity)
+            m_entries.resize(capacity);
+    }
+
+    void Statistics::merge(Statistics const &other) {
+        m_moments.merge(other.m_moments);
+        m_quantiles.merge(other.m_quantiles);
+        m_top.merge(other.m_top);
+    }
+
+    void Statistics::clear() {
+        m_moments.clear();
+        m_quantiles.clear();
+        m_top.clear();
+    }
+
+}
@@ -0,0 +1,85 @@
+#include "utils/thread_pool.hpp"
+
+namespace util {
+
+    ThreadPool::ThreadPool(size_t nthreads) : m_task(nullptr), m_generation(0), m_pending(0), m_stop(false) {
+        if (nthreads == 0)
+            nthreads = 1;
+
+        m_workers.reserve(nthreads);
+
+        for (size_t i = 0; i < nthreads; i++)
+            m_workers.emplace_back(&ThreadPool::work, this, i);
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_start.notify_all();
+
+        for (auto &worker : m_workers)
+            worker.join();
+    }
+
+    void ThreadPool::work(size_t index) {
+        size_t generation = 0;
+
+        while (true) {
+            std::function<void(size_t)> const *task;
+
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_start.wait(lock, [&] { return m_stop || m_generation != generation; });
+
+                if (m_stop)
+                    return;
+
+                generation = m_generation;
+                task = m_task;
+            }
+
+            std::exception_ptr error;
+
+            try {
+                (*task)(index);
+            } catch (...) {
+                error = std::current_exception();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+
+                if (error && !m_error)
+                    m_error = error;
+
+                if (--m_pending == 0)
+                    m_done.notify_one();
+            }
+        }
+    }
+
+    void ThreadPool::run(std::function<void(size_t)> const &task) {
+        std::exception_ptr error;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            m_task = &task;
+            m_error = nullptr;
+            m_pending = m_workers.size();
+            m_generation++;
+
+            m_start.notify_all();
+            m_done.wait(lock, [&] { return m_pending == 0; });
+
+            m_task = nullptr;
+            error = m_error;
+        }
+
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+}
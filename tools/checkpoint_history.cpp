@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "neural_network/delta.hpp"
+
+using namespace neuralnetwork;
+
+// Historique écrit par CheckpointHistory :
+//   checkpoint_history <dossier> <préfixe> list
+//   checkpoint_history <dossier> <préfixe> restore <génération> <sortie.ckpt>
+// restore reconstruit la génération depuis la dernière base et écrit un point de reprise complet (voir loadCheckpoint).
+
+static int usage() {
+    std::fprintf(stderr, "usage : checkpoint_history <dossier> <prefixe> list\n"
+                         "        checkpoint_history <dossier> <prefixe> restore <generation> <sortie.ckpt>\n");
+    return 1;
+}
+
+static int list(std::string const &directory, std::string const &prefix) {
+    DIR *dir = opendir(directory.c_str());
+    if (dir == nullptr) {
+        std::perror(directory.c_str());
+        return 1;
+    }
+
+    struct Entry
+    {
+        unsigned long long generation;
+        std::string name;
+        bool base;
+        long long size;
+    };
+
+    std::vector<Entry> entries;
+    std::string const head = prefix + "-";
+
+    while (dirent *entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        size_t dot = name.rfind('.');
+
+        if (name.compare(0, head.size(), head) != 0 || dot == std::string::npos || dot <= head.size())
+            continue;
+
+        std::string extension = name.substr(dot + 1);
+        std::string digits = name.substr(head.size(), dot - head.size());
+
+        if ((extension != "ckpt" && extension != "delta") || digits.find_first_not_of("0123456789") != std::string::npos)
+            continue;
+
+        struct stat info;
+        if (stat((directory + "/" + name).c_str(), &info) != 0)
+            continue;
+
+        entries.push_back({std::stoull(digits), name, extension == "ckpt", (long long)info.st_size});
+    }
+    closedir(dir);
+
+    std::sort(entries.begin(), entries.end(), [](Entry const &a, Entry const &b) { return a.generation < b.generation; });
+
+    long long bases = 0, deltas = 0;
+    for (Entry const &entry : entries) {
+        std::printf("%10llu  %-5s  %12lld  %s\n", entry.generation, entry.base ? "base" : "delta", entry.size, entry.name.c_str());
+        (entry.base ? bases : deltas) += entry.size;
+    }
+
+    std::printf("bases : %lld octets, deltas : %lld octets\n", bases, deltas);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 4)
+        return usage();
+
+    std::string const directory = argv[1], prefix = argv[2], command = argv[3];
+
+    try {
+        if (command == "list")
+            return list(directory, prefix);
+
+        if (command == "restore" && argc == 6) {
+            uint64_t generation = std::strtoull(argv[4], nullptr, 10);
+
+            delta::Snapshot snapshot = delta::reconstruct(directory, prefix, generation);
+            delta::save(snapshot, argv[5]);
+
+            std::printf("generation %llu : %llu genomes de %llu valeurs -> %s\n", (unsigned long long)generation,
+                        (unsigned long long)snapshot.header.population, (unsigned long long)snapshot.header.nparams, argv[5]);
+            return 0;
+        }
+    } catch (std::exception const &e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+
+    return usage();
+}